@@ -0,0 +1,147 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_algorithms
+{
+	/**
+	 * \brief Класс, оценивающий количество инверсий в потоке известной длины за один проход по случайной выборке пар.
+	 * \brief Заранее выбирается m = ceil(ln(2 / delta) / (2 * epsilon^2)) случайных пар позиций (i < j), при проходе по потоку
+	 * \brief запоминается a[i] и при поступлении a[j] пара проверяется на инверсию. По неравенству Хёфдинга доля инвертированных пар
+	 * \brief в выборке отличается от доли инверсий среди всех n(n-1)/2 пар (нормированного расстояния Кендалла) не более чем на epsilon
+	 * \brief с вероятностью не меньше 1 - delta. Память: O(m), не зависит от длины потока. Время: O(m * log(m) + n).
+	 * \tparam T Тип элементов потока.
+	 */
+	template<typename T>
+	class ApproximateInversionCounter
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param streamLength Длина потока n (не меньше 2).
+		 * \param epsilon Допустимая абсолютная погрешность доли инверсий.
+		 * \param delta Допустимая вероятность выхода за погрешность.
+		 * \param seed Начальное значение генератора случайных чисел.
+		 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		ApproximateInversionCounter(uint64_t streamLength, double epsilon, double delta, uint64_t seed = std::mt19937_64::default_seed, const std::function<bool(const T& lhs, const T& rhs)>& less = std::less<T>());
+		~ApproximateInversionCounter() = default;
+
+		ApproximateInversionCounter(const ApproximateInversionCounter& other) = delete;
+		ApproximateInversionCounter(ApproximateInversionCounter&& other) noexcept = delete;
+		ApproximateInversionCounter& operator=(const ApproximateInversionCounter& other) = delete;
+		ApproximateInversionCounter& operator=(ApproximateInversionCounter&& other) noexcept = delete;
+
+		/**
+		 * \brief Обработка очередного элемента потока.
+		 * \param value Элемент потока.
+		 */
+		void push(const T& value);
+
+		/**
+		 * \brief Оценка доли инвертированных пар среди всех пар потока (нормированное расстояние Кендалла до отсортированного порядка).
+		 * \brief До окончания потока оценивается по уже завершённым парам выборки.
+		 */
+		[[nodiscard]] double disorder() const;
+
+		/**
+		 * \brief Оценка количества инверсий в потоке: disorder() * n(n-1)/2.
+		 */
+		[[nodiscard]] double inversions() const;
+
+		/**
+		 * \brief Количество пар в выборке.
+		 */
+		[[nodiscard]] size_t samplesNumber() const { return firstPositions_.size(); }
+
+	private:
+		/**
+		 * \brief Позиции первых и вторых элементов пар выборки, упорядоченные по возрастанию позиции. Пары: позиция, номер пары.
+		 */
+		std::vector<std::pair<uint64_t, uint32_t>> firstPositions_;
+		std::vector<std::pair<uint64_t, uint32_t>> secondPositions_;
+		/**
+		 * \brief Значения первых элементов пар, запомненные при проходе по потоку.
+		 */
+		std::vector<T> firstValues_;
+		size_t firstIterator_{ 0 };
+		size_t secondIterator_{ 0 };
+		size_t invertedPairs_{ 0 };
+		uint64_t position_{ 0 };
+		uint64_t streamLength_{ 0 };
+		std::function<bool(const T& lhs, const T& rhs)> less_;
+	};
+
+	template <typename T>
+	ApproximateInversionCounter<T>::ApproximateInversionCounter(const uint64_t streamLength, const double epsilon, const double delta, const uint64_t seed, const std::function<bool(const T& lhs, const T& rhs)>& less)
+		: streamLength_(streamLength), less_(less)
+	{
+		assert(streamLength >= 2 && epsilon > 0 && delta > 0 && delta < 1);
+		const auto samples = static_cast<size_t>(std::ceil(std::log(2.0 / delta) / (2.0 * epsilon * epsilon)));
+		std::mt19937_64 generator(seed);
+		std::uniform_int_distribution<uint64_t> positions(0, streamLength - 1);
+		firstPositions_.reserve(samples);
+		secondPositions_.reserve(samples);
+		for (uint32_t pair = 0; pair < samples; ++pair)
+		{
+			//Равномерно выбираем пару различных позиций
+			auto first = positions(generator);
+			auto second = positions(generator);
+			while (first == second)
+			{
+				second = positions(generator);
+			}
+			if (second < first)
+			{
+				std::swap(first, second);
+			}
+			firstPositions_.emplace_back(first, pair);
+			secondPositions_.emplace_back(second, pair);
+		}
+		std::sort(firstPositions_.begin(), firstPositions_.end());
+		std::sort(secondPositions_.begin(), secondPositions_.end());
+		firstValues_.resize(samples);
+	}
+
+	template <typename T>
+	void ApproximateInversionCounter<T>::push(const T& value)
+	{
+		//Одна позиция может быть второй в одних парах и первой в других, но пара всегда завершается позже, чем начинается
+		while (secondIterator_ < secondPositions_.size() && secondPositions_[secondIterator_].first == position_)
+		{
+			if (less_(value, firstValues_[secondPositions_[secondIterator_].second]))
+			{
+				invertedPairs_ += 1;
+			}
+			secondIterator_ += 1;
+		}
+		while (firstIterator_ < firstPositions_.size() && firstPositions_[firstIterator_].first == position_)
+		{
+			firstValues_[firstPositions_[firstIterator_].second] = value;
+			firstIterator_ += 1;
+		}
+		position_ += 1;
+	}
+
+	template <typename T>
+	double ApproximateInversionCounter<T>::disorder() const
+	{
+		if (secondIterator_ == 0)
+		{
+			return 0;
+		}
+		return static_cast<double>(invertedPairs_) / static_cast<double>(secondIterator_);
+	}
+
+	template <typename T>
+	double ApproximateInversionCounter<T>::inversions() const
+	{
+		const auto pairsNumber = static_cast<double>(streamLength_) * static_cast<double>(streamLength_ - 1) / 2;
+		return disorder() * pairsNumber;
+	}
+}
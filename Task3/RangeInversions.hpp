@@ -0,0 +1,140 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_containers
+{
+	/**
+	 * \brief Дерево Фенвика для подсчёта количества элементов с рангом не больше заданного.
+	 */
+	class FenwickTree
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param size Количество различных рангов (ранги от 0 до size - 1).
+		 */
+		explicit FenwickTree(const size_t size) : data_(size + 1, 0) {}
+
+		/**
+		 * \brief Изменение количества элементов с рангом rank на delta.
+		 */
+		void add(const size_t rank, const int32_t delta)
+		{
+			for (auto i = rank + 1; i < data_.size(); i += i & (~i + 1))
+			{
+				data_[i] += delta;
+			}
+		}
+
+		/**
+		 * \brief Количество элементов с рангом строго меньше rank.
+		 */
+		[[nodiscard]] size_t countLess(const size_t rank) const
+		{
+			int64_t count = 0;
+			for (auto i = rank; i > 0; i -= i & (~i + 1))
+			{
+				count += data_[i];
+			}
+			return static_cast<size_t>(count);
+		}
+
+	private:
+		std::vector<int32_t> data_;
+	};
+}
+
+namespace custom_algorithms
+{
+	/**
+	 * \brief Функция, отвечающая на пакет запросов о количестве инверсий в подотрезках массива (алгоритм Мо с деревом Фенвика).
+	 * \brief Запросы сортируются по блокам левой границы, после чего окно [l..r] перемещается между соседними запросами
+	 * \brief поэлементно. Время работы: O((n + Q) * sqrt(n) * log(n)), дополнительная память: O(n + Q).
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param queries Запросы: пары индексов (l, r), l <= r < n, границы включаются.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Количество инверсий в a[l..r] для каждого запроса в исходном порядке запросов.
+	 */
+	template<typename T>
+	std::vector<size_t> countRangeInversions(const std::vector<T>& arrayNumbers, const std::vector<std::pair<size_t, size_t>>& queries, const std::function<bool(const T& lhs, const T& rhs)> less = std::less<T>())
+	{
+		//Сжимаем значения в ранги, равные элементы получают одинаковый ранг
+		std::vector<uint32_t> order(arrayNumbers.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&arrayNumbers, &less](const uint32_t lhs, const uint32_t rhs) { return less(arrayNumbers[lhs], arrayNumbers[rhs]); });
+		std::vector<uint32_t> ranks(arrayNumbers.size());
+		uint32_t ranksNumber = 0;
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			if (i > 0 && less(arrayNumbers[order[i - 1]], arrayNumbers[order[i]]))
+			{
+				ranksNumber += 1;
+			}
+			ranks[order[i]] = ranksNumber;
+		}
+
+		//Порядок обхода запросов: по блокам левой границы, внутри блока - по правой границе змейкой
+		const auto blockSize = std::max<size_t>(1, static_cast<size_t>(arrayNumbers.size() / std::sqrt(std::max<size_t>(1, queries.size()))));
+		std::vector<uint32_t> queriesOrder(queries.size());
+		std::iota(queriesOrder.begin(), queriesOrder.end(), 0);
+		std::sort(queriesOrder.begin(), queriesOrder.end(), [&queries, blockSize](const uint32_t lhs, const uint32_t rhs)
+		{
+			const auto lhsBlock = queries[lhs].first / blockSize;
+			const auto rhsBlock = queries[rhs].first / blockSize;
+			if (lhsBlock != rhsBlock)
+			{
+				return lhsBlock < rhsBlock;
+			}
+			return (lhsBlock % 2 == 0) ? queries[lhs].second < queries[rhs].second : queries[lhs].second > queries[rhs].second;
+		});
+
+		//Текущее окно - полуинтервал [leftBorder, rightBorder)
+		custom_containers::FenwickTree counts(ranksNumber + 1);
+		size_t leftBorder = 0;
+		size_t rightBorder = 0;
+		size_t inversionsNumber = 0;
+		std::vector<size_t> answers(queries.size());
+		for (const auto query : queriesOrder)
+		{
+			assert(queries[query].first <= queries[query].second && queries[query].second < arrayNumbers.size());
+			const auto queryLeft = queries[query].first;
+			const auto queryRight = queries[query].second + 1;
+			//Сначала расширяем окно, затем сужаем, чтобы оно не становилось отрицательной длины
+			while (rightBorder < queryRight)
+			{
+				//Новый правый элемент образует инверсии со всеми большими элементами окна
+				inversionsNumber += (rightBorder - leftBorder) - counts.countLess(ranks[rightBorder] + 1);
+				counts.add(ranks[rightBorder], 1);
+				rightBorder += 1;
+			}
+			while (leftBorder > queryLeft)
+			{
+				//Новый левый элемент образует инверсии со всеми меньшими элементами окна
+				leftBorder -= 1;
+				inversionsNumber += counts.countLess(ranks[leftBorder]);
+				counts.add(ranks[leftBorder], 1);
+			}
+			while (rightBorder > queryRight)
+			{
+				rightBorder -= 1;
+				counts.add(ranks[rightBorder], -1);
+				inversionsNumber -= (rightBorder - leftBorder) - counts.countLess(ranks[rightBorder] + 1);
+			}
+			while (leftBorder < queryLeft)
+			{
+				counts.add(ranks[leftBorder], -1);
+				inversionsNumber -= counts.countLess(ranks[leftBorder]);
+				leftBorder += 1;
+			}
+			answers[query] = inversionsNumber;
+		}
+		return answers;
+	}
+}
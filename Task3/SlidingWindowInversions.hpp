@@ -0,0 +1,222 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <random>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_containers
+{
+	/**
+	 * \brief Класс, поддерживающий количество инверсий среди последних windowSize элементов потока.
+	 * \brief Элементы окна хранятся в декартовом дереве (treap) с размерами поддеревьев, что позволяет за O(log W)
+	 * \brief узнать, сколько элементов окна меньше или больше заданного. Узлы дерева лежат в одном массиве и переиспользуются.
+	 * \tparam T Тип элементов потока.
+	 */
+	template<typename T>
+	class SlidingWindowInversions
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param windowSize Размер окна W (должен быть больше нуля).
+		 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		explicit SlidingWindowInversions(size_t windowSize, const std::function<bool(const T& lhs, const T& rhs)>& less = std::less<T>());
+		~SlidingWindowInversions() = default;
+
+		SlidingWindowInversions(const SlidingWindowInversions& other) = delete;
+		SlidingWindowInversions(SlidingWindowInversions&& other) noexcept = delete;
+		SlidingWindowInversions& operator=(const SlidingWindowInversions& other) = delete;
+		SlidingWindowInversions& operator=(SlidingWindowInversions&& other) noexcept = delete;
+
+		/**
+		 * \brief Добавление очередного элемента потока. Если окно заполнено, из него вытесняется самый старый элемент.
+		 * \param value Добавляемый элемент.
+		 */
+		void push(const T& value);
+
+		/**
+		 * \brief Количество инверсий среди элементов окна.
+		 * \return Количество пар (i < j) в окне, для которых a[i] > a[j].
+		 */
+		[[nodiscard]] size_t inversions() const { return inversions_; }
+
+		/**
+		 * \brief Количество элементов в окне.
+		 */
+		[[nodiscard]] size_t size() const { return nodes_[root_].size; }
+
+	private:
+		/**
+		 * \brief Узел декартова дерева. Индекс 0 зарезервирован под пустой узел.
+		 */
+		struct Node
+		{
+			T key{};
+			uint32_t priority{ 0 };
+			uint32_t left{ 0 };
+			uint32_t right{ 0 };
+			uint32_t size{ 0 };
+		};
+
+		/**
+		 * \brief Количество элементов окна, строго меньших value (или не больших, если orEqual == true).
+		 */
+		size_t countLess(const T& value, bool orEqual) const;
+
+		/**
+		 * \brief Разрезает дерево на элементы, строго меньшие value (или не большие, если orEqual == true), и остальные.
+		 * \return Пара корней: левая и правая части.
+		 */
+		std::pair<uint32_t, uint32_t> split(uint32_t node, const T& value, bool orEqual);
+
+		/**
+		 * \brief Сливает два дерева, если все ключи левого не больше всех ключей правого.
+		 * \return Корень объединённого дерева.
+		 */
+		uint32_t merge(uint32_t left, uint32_t right);
+
+		void update(uint32_t node) { nodes_[node].size = nodes_[nodes_[node].left].size + nodes_[nodes_[node].right].size + 1; }
+
+		void insert(const T& value);
+		void erase(const T& value);
+
+		/**
+		 * \brief Кольцевой буфер с элементами окна в порядке поступления.
+		 */
+		std::vector<T> window_;
+		/**
+		 * \brief Размер окна. Ёмкость window_ после reserve может быть больше, поэтому хранится отдельно.
+		 */
+		size_t windowSize_;
+		size_t oldest_{ 0 };
+		size_t inversions_{ 0 };
+
+		std::vector<Node> nodes_;
+		std::vector<uint32_t> freeNodes_;
+		uint32_t root_{ 0 };
+		std::mt19937 generator_;
+		std::function<bool(const T& lhs, const T& rhs)> less_;
+	};
+
+	template <typename T>
+	SlidingWindowInversions<T>::SlidingWindowInversions(size_t windowSize, const std::function<bool(const T& lhs, const T& rhs)>& less) : windowSize_(windowSize), less_(less)
+	{
+		assert(windowSize > 0);
+		window_.reserve(windowSize);
+		nodes_.resize(windowSize + 1);
+		freeNodes_.reserve(windowSize);
+		for (auto node = static_cast<uint32_t>(windowSize); node > 0; --node)
+		{
+			freeNodes_.push_back(node);
+		}
+	}
+
+	template <typename T>
+	void SlidingWindowInversions<T>::push(const T& value)
+	{
+		if (window_.size() < windowSize_)
+		{
+			window_.push_back(value);
+		}
+		else
+		{
+			//Вытесняемый элемент стоит раньше всех остальных, поэтому образует инверсии со всеми меньшими его
+			erase(window_[oldest_]);
+			inversions_ -= countLess(window_[oldest_], false);
+			window_[oldest_] = value;
+			oldest_ = (oldest_ + 1) % window_.size();
+		}
+		//Новый элемент стоит позже всех остальных, поэтому образует инверсии со всеми большими его
+		inversions_ += size() - countLess(value, true);
+		insert(value);
+	}
+
+	template <typename T>
+	size_t SlidingWindowInversions<T>::countLess(const T& value, const bool orEqual) const
+	{
+		size_t count = 0;
+		auto node = root_;
+		while (node != 0)
+		{
+			const auto goRight = orEqual ? !less_(value, nodes_[node].key) : less_(nodes_[node].key, value);
+			if (goRight)
+			{
+				count += nodes_[nodes_[node].left].size + 1;
+				node = nodes_[node].right;
+			}
+			else
+			{
+				node = nodes_[node].left;
+			}
+		}
+		return count;
+	}
+
+	template <typename T>
+	std::pair<uint32_t, uint32_t> SlidingWindowInversions<T>::split(const uint32_t node, const T& value, const bool orEqual)
+	{
+		if (node == 0)
+		{
+			return { 0, 0 };
+		}
+		const auto toLeft = orEqual ? !less_(value, nodes_[node].key) : less_(nodes_[node].key, value);
+		if (toLeft)
+		{
+			const auto parts = split(nodes_[node].right, value, orEqual);
+			nodes_[node].right = parts.first;
+			update(node);
+			return { node, parts.second };
+		}
+		const auto parts = split(nodes_[node].left, value, orEqual);
+		nodes_[node].left = parts.second;
+		update(node);
+		return { parts.first, node };
+	}
+
+	template <typename T>
+	uint32_t SlidingWindowInversions<T>::merge(const uint32_t left, const uint32_t right)
+	{
+		if (left == 0 || right == 0)
+		{
+			return left + right;
+		}
+		if (nodes_[left].priority > nodes_[right].priority)
+		{
+			nodes_[left].right = merge(nodes_[left].right, right);
+			update(left);
+			return left;
+		}
+		nodes_[right].left = merge(left, nodes_[right].left);
+		update(right);
+		return right;
+	}
+
+	template <typename T>
+	void SlidingWindowInversions<T>::insert(const T& value)
+	{
+		const auto node = freeNodes_.back();
+		freeNodes_.pop_back();
+		nodes_[node].key = value;
+		nodes_[node].priority = static_cast<uint32_t>(generator_());
+		nodes_[node].left = 0;
+		nodes_[node].right = 0;
+		nodes_[node].size = 1;
+		const auto parts = split(root_, value, true);
+		root_ = merge(merge(parts.first, node), parts.second);
+	}
+
+	template <typename T>
+	void SlidingWindowInversions<T>::erase(const T& value)
+	{
+		//Выделяем поддерево из элементов, равных value, и удаляем его корень
+		const auto lessParts = split(root_, value, false);
+		const auto equalParts = split(lessParts.second, value, true);
+		assert(equalParts.first != 0);
+		const auto removed = equalParts.first;
+		freeNodes_.push_back(removed);
+		const auto equalRest = merge(nodes_[removed].left, nodes_[removed].right);
+		root_ = merge(lessParts.first, merge(equalRest, equalParts.second));
+	}
+}
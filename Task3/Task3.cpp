@@ -37,11 +37,30 @@
 * Оценка сложности алгоритма.
 * Дополнительная память: O(n).
 * Среднее время работы: O(n*log(n)).
+*
+* Сортировка слиянием без буфера (inPlaceMergeSort).
+* Дополнительная память: O(log(n)) на стек рекурсии.
+* Время работы: O(n*log^2(n)).
+*
+* Естественная сортировка слиянием (naturalMergeSort, в духе Timsort).
+* Дополнительная память: O(n).
+* Время работы: O(n*log(n)) в худшем случае, O(n + n*log(r)) для массива из r упорядоченных серий.
 */
 
 #include <iostream>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <cmath>
+#include <string>
+#include "SlidingWindowInversions.hpp"
+#include "RangeInversions.hpp"
+#include "ApproximateInversions.hpp"
 
 namespace custom_algorithms
 {
@@ -119,16 +138,600 @@ namespace custom_algorithms
 		}
         return inversionsNumber;
 	}
+
+	/**
+	 * \brief Количество подряд выигранных одной серией сравнений, после которого слияние переходит в режим галопа.
+	 */
+	constexpr size_t kMinimalGallop = 7;
+
+	/**
+	 * \brief Функция, вычисляющая минимальную длину серии для естественной сортировки слиянием.
+	 * \brief Короткие серии дополняются до этой длины вставками, чтобы количество серий было близко к степени двойки.
+	 * \param size Количество элементов в массиве.
+	 * \return Минимальная длина серии (от 32 до 64 для массивов из 64 и более элементов).
+	 */
+	inline size_t calculateMinimalRunLength(size_t size)
+	{
+		size_t remainder = 0;
+		while (size >= 64)
+		{
+			remainder |= size & 1;
+			size >>= 1;
+		}
+		return size + remainder;
+	}
+
+	/**
+	 * \brief Экспоненциальный (галопирующий) поиск первого элемента, строго большего key. Аналог std::upper_bound.
+	 * \tparam RandomIt Тип итератора произвольного доступа.
+	 * \tparam T Тип элементов.
+	 * \param first Начало отсортированного диапазона.
+	 * \param last Конец отсортированного диапазона.
+	 * \param key Искомое значение.
+	 * \param less Функция сравнения элементов.
+	 * \return Итератор на первый элемент, строго больший key, или last.
+	 */
+	template<typename RandomIt, typename T>
+	RandomIt gallopUpperBound(RandomIt first, RandomIt last, const T& key, const std::function<bool(const T& lhs, const T& rhs)>& less)
+	{
+		const auto size = static_cast<size_t>(last - first);
+		//Проверяем элементы с индексами 0, 1, 3, 7, ..., пока они не больше key
+		size_t bound = 1;
+		while (bound <= size && !less(key, first[bound - 1]))
+		{
+			bound *= 2;
+		}
+		return std::upper_bound(first + bound / 2, first + std::min(bound, size), key, less);
+	}
+
+	/**
+	 * \brief Экспоненциальный (галопирующий) поиск первого элемента, не меньшего key. Аналог std::lower_bound.
+	 * \tparam RandomIt Тип итератора произвольного доступа.
+	 * \tparam T Тип элементов.
+	 * \param first Начало отсортированного диапазона.
+	 * \param last Конец отсортированного диапазона.
+	 * \param key Искомое значение.
+	 * \param less Функция сравнения элементов.
+	 * \return Итератор на первый элемент, не меньший key, или last.
+	 */
+	template<typename RandomIt, typename T>
+	RandomIt gallopLowerBound(RandomIt first, RandomIt last, const T& key, const std::function<bool(const T& lhs, const T& rhs)>& less)
+	{
+		const auto size = static_cast<size_t>(last - first);
+		//Проверяем элементы с индексами 0, 1, 3, 7, ..., пока они меньше key
+		size_t bound = 1;
+		while (bound <= size && less(first[bound - 1], key))
+		{
+			bound *= 2;
+		}
+		return std::lower_bound(first + bound / 2, first + std::min(bound, size), key, less);
+	}
+
+	/**
+	 * \brief Функция, выполняющая слияние двух соседних отсортированных серий с галопом и подсчётом инверсий.
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param leftBorder Начало левой серии.
+	 * \param midBorder Начало правой серии.
+	 * \param rightBorder Конец (за последним элементом) правой серии.
+	 * \param buffer Вспомогательный буфер, переиспользуемый между слияниями.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Количество инверсий между элементами левой и правой серий.
+	 */
+	template<typename T>
+	size_t mergeRuns(std::vector<T>& arrayNumbers, size_t leftBorder, const size_t midBorder, size_t rightBorder, std::vector<T>& buffer, const std::function<bool(const T& lhs, const T& rhs)>& less)
+	{
+		const auto begin = arrayNumbers.begin();
+		//Элементы левой серии, не большие первого элемента правой, уже стоят на своих местах и инверсий не образуют
+		leftBorder = gallopUpperBound(begin + leftBorder, begin + midBorder, arrayNumbers[midBorder], less) - begin;
+		if (leftBorder == midBorder)
+		{
+			return 0;
+		}
+		//Элементы правой серии, не меньшие последнего элемента левой, тоже уже стоят на своих местах
+		rightBorder = gallopLowerBound(begin + midBorder, begin + rightBorder, arrayNumbers[midBorder - 1], less) - begin;
+
+		//Левую серию переносим в буфер, слияние ведём на её место
+		buffer.assign(begin + leftBorder, begin + midBorder);
+		size_t inversionsNumber = 0;
+		size_t leftIterator = 0;
+		auto rightIterator = midBorder;
+		auto mergeIterator = leftBorder;
+		size_t leftWins = 0;
+		size_t rightWins = 0;
+		while (leftIterator < buffer.size() && rightIterator < rightBorder)
+		{
+			if (less(arrayNumbers[rightIterator], buffer[leftIterator]))
+			{
+				//Элемент в правой серии меньше элемента в левой. Инверсии со всеми оставшимися элементами левой серии.
+				arrayNumbers[mergeIterator++] = arrayNumbers[rightIterator++];
+				inversionsNumber += buffer.size() - leftIterator;
+				rightWins += 1;
+				leftWins = 0;
+			}
+			else
+			{
+				arrayNumbers[mergeIterator++] = buffer[leftIterator++];
+				leftWins += 1;
+				rightWins = 0;
+			}
+			if (leftIterator == buffer.size() || rightIterator == rightBorder)
+			{
+				break;
+			}
+
+			if (rightWins >= kMinimalGallop)
+			{
+				//Галоп по правой серии: все её элементы, меньшие текущего элемента левой, переносятся одним блоком,
+				//и каждый из них образует инверсию со всеми оставшимися элементами левой серии
+				const auto gallopEnd = gallopLowerBound(begin + rightIterator, begin + rightBorder, buffer[leftIterator], less) - begin;
+				inversionsNumber += (gallopEnd - rightIterator) * (buffer.size() - leftIterator);
+				std::copy(begin + rightIterator, begin + gallopEnd, begin + mergeIterator);
+				mergeIterator += gallopEnd - rightIterator;
+				rightIterator = gallopEnd;
+				rightWins = 0;
+			}
+			else if (leftWins >= kMinimalGallop)
+			{
+				//Галоп по левой серии: все её элементы, не большие текущего элемента правой, переносятся одним блоком без инверсий
+				const auto gallopEnd = gallopUpperBound(buffer.begin() + leftIterator, buffer.end(), arrayNumbers[rightIterator], less) - buffer.begin();
+				std::copy(buffer.begin() + leftIterator, buffer.begin() + gallopEnd, begin + mergeIterator);
+				mergeIterator += gallopEnd - leftIterator;
+				leftIterator = gallopEnd;
+				leftWins = 0;
+			}
+		}
+		//Остаток правой серии уже стоит на месте, переносим только остаток левой
+		std::copy(buffer.begin() + leftIterator, buffer.end(), begin + mergeIterator);
+		return inversionsNumber;
+	}
+
+	/**
+	 * \brief Функция, сливающая серии на вершине стека, пока не выполнены инварианты стека серий Timsort.
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param runs Стек серий: пары (начало серии, длина серии).
+	 * \param buffer Вспомогательный буфер для слияний.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \param force Если true, то сливаются все серии стека.
+	 * \return Количество инверсий, найденных при слияниях.
+	 */
+	template<typename T>
+	size_t collapseRuns(std::vector<T>& arrayNumbers, std::vector<std::pair<size_t, size_t>>& runs, std::vector<T>& buffer, const std::function<bool(const T& lhs, const T& rhs)>& less, const bool force)
+	{
+		size_t inversionsNumber = 0;
+		while (runs.size() > 1)
+		{
+			auto n = runs.size() - 2;
+			if (force)
+			{
+				if (n > 0 && runs[n - 1].second < runs[n + 1].second)
+				{
+					n -= 1;
+				}
+			}
+			else if ((n > 0 && runs[n - 1].second <= runs[n].second + runs[n + 1].second) ||
+				(n > 1 && runs[n - 2].second <= runs[n - 1].second + runs[n].second))
+			{
+				if (runs[n - 1].second < runs[n + 1].second)
+				{
+					n -= 1;
+				}
+			}
+			else if (runs[n].second > runs[n + 1].second)
+			{
+				break;
+			}
+			inversionsNumber += mergeRuns(arrayNumbers, runs[n].first, runs[n + 1].first, runs[n + 1].first + runs[n + 1].second, buffer, less);
+			runs[n].second += runs[n + 1].second;
+			runs.erase(runs.begin() + n + 1);
+		}
+		return inversionsNumber;
+	}
+
+	/**
+	 * \brief Функция, выполняющая естественную сортировку слиянием (в духе Timsort) в исходном массиве с подсчётом инверсий.
+	 * \brief Находит уже упорядоченные серии, строго убывающие серии разворачивает, короткие дополняет вставками
+	 * \brief и сливает серии по правилам стека Timsort с галопом. На почти отсортированных данных работает за время, близкое к O(n).
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Количество инверсий.
+	 */
+	template<typename T>
+	size_t naturalMergeSort(std::vector<T>& arrayNumbers, const std::function<bool(const T& lhs, const T& rhs)> less = std::less<T>())
+	{
+		size_t inversionsNumber = 0;
+		const auto begin = arrayNumbers.begin();
+		const auto size = arrayNumbers.size();
+		const auto minimalRunLength = calculateMinimalRunLength(size);
+		std::vector<std::pair<size_t, size_t>> runs;
+		std::vector<T> buffer;
+		size_t runBegin = 0;
+		while (runBegin < size)
+		{
+			auto runEnd = runBegin + 1;
+			if (runEnd < size && less(arrayNumbers[runEnd], arrayNumbers[runBegin]))
+			{
+				//Строго убывающую серию разворачиваем. Все пары её элементов - инверсии.
+				while (runEnd < size && less(arrayNumbers[runEnd], arrayNumbers[runEnd - 1]))
+				{
+					runEnd += 1;
+				}
+				std::reverse(begin + runBegin, begin + runEnd);
+				const auto runLength = runEnd - runBegin;
+				inversionsNumber += runLength * (runLength - 1) / 2;
+			}
+			else
+			{
+				while (runEnd < size && !less(arrayNumbers[runEnd], arrayNumbers[runEnd - 1]))
+				{
+					runEnd += 1;
+				}
+			}
+
+			//Короткую серию дополняем бинарными вставками. Вставляемый элемент образует инверсии со всеми элементами, которые он обгоняет.
+			const auto forcedRunEnd = std::min(size, runBegin + minimalRunLength);
+			for (; runEnd < forcedRunEnd; ++runEnd)
+			{
+				const auto insertPlace = std::upper_bound(begin + runBegin, begin + runEnd, arrayNumbers[runEnd], less);
+				inversionsNumber += (begin + runEnd) - insertPlace;
+				std::rotate(insertPlace, begin + runEnd, begin + runEnd + 1);
+			}
+
+			runs.emplace_back(runBegin, runEnd - runBegin);
+			inversionsNumber += collapseRuns(arrayNumbers, runs, buffer, less, false);
+			runBegin = runEnd;
+		}
+		inversionsNumber += collapseRuns(arrayNumbers, runs, buffer, less, true);
+		return inversionsNumber;
+	}
+
+	/**
+	 * \brief Функция, выполняющая слияние двух соседних отсортированных блоков без дополнительного буфера с подсчётом инверсий.
+	 * \brief В большем блоке берётся средний элемент (опорный), в другом блоке бинарным поиском находится граница элементов,
+	 * \brief которые должны оказаться по другую сторону от опорного. Циклический сдвиг (std::rotate) ставит опорный элемент на его
+	 * \brief окончательное место, все пары переставленных элементов - инверсии. Остаются две независимые задачи слияния меньшего размера.
+	 * \brief Время работы: O((n1 + n2) * log(n1 + n2)), память: O(log(n1 + n2)) на стек рекурсии.
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param leftBorder Начало левого блока.
+	 * \param midBorder Начало правого блока.
+	 * \param rightBorder Конец (за последним элементом) правого блока.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Количество инверсий между элементами левого и правого блоков.
+	 */
+	template<typename T>
+	size_t rotationMerge(std::vector<T>& arrayNumbers, size_t leftBorder, size_t midBorder, size_t rightBorder, const std::function<bool(const T& lhs, const T& rhs)>& less)
+	{
+		const auto begin = arrayNumbers.begin();
+		size_t inversionsNumber = 0;
+		while (leftBorder < midBorder && midBorder < rightBorder && less(arrayNumbers[midBorder], arrayNumbers[midBorder - 1]))
+		{
+			//Границы переставляемых частей [leftCut, midBorder) и [midBorder, rightCut), позиция опорного элемента после перестановки
+			size_t leftCut = 0;
+			size_t rightCut = 0;
+			size_t pivotPosition = 0;
+			if (midBorder - leftBorder >= rightBorder - midBorder)
+			{
+				//Опорный элемент в левом блоке. Перед ним должны встать элементы правого блока, строго меньшие его.
+				leftCut = leftBorder + (midBorder - leftBorder) / 2;
+				rightCut = std::lower_bound(begin + midBorder, begin + rightBorder, arrayNumbers[leftCut], less) - begin;
+				pivotPosition = leftCut + (rightCut - midBorder);
+			}
+			else
+			{
+				//Опорный элемент в правом блоке. После него должны встать элементы левого блока, строго большие его.
+				const auto pivot = midBorder + (rightBorder - midBorder) / 2;
+				leftCut = std::upper_bound(begin + leftBorder, begin + midBorder, arrayNumbers[pivot], less) - begin;
+				rightCut = pivot + 1;
+				pivotPosition = leftCut + (pivot - midBorder);
+			}
+			inversionsNumber += (midBorder - leftCut) * (rightCut - midBorder);
+			std::rotate(begin + leftCut, begin + midBorder, begin + rightCut);
+
+			//Остаются две независимые задачи слияния:
+			//слева от опорного элемента блоки [leftBorder, leftCut) и [leftCut, pivotPosition),
+			//справа от опорного элемента блоки [pivotPosition + 1, rightCut) и [rightCut, rightBorder)
+			const auto leftTaskSize = pivotPosition - leftBorder;
+			const auto rightTaskSize = rightBorder - pivotPosition - 1;
+			//Меньшую задачу решаем рекурсивно, большую - в этом же цикле, чтобы глубина рекурсии была O(log n)
+			if (leftTaskSize < rightTaskSize)
+			{
+				inversionsNumber += rotationMerge(arrayNumbers, leftBorder, leftCut, pivotPosition, less);
+				leftBorder = pivotPosition + 1;
+				midBorder = rightCut;
+			}
+			else
+			{
+				inversionsNumber += rotationMerge(arrayNumbers, pivotPosition + 1, rightCut, rightBorder, less);
+				midBorder = leftCut;
+				rightBorder = pivotPosition;
+			}
+		}
+		return inversionsNumber;
+	}
+
+	/**
+	 * \brief Функция, выполняющая сортировку слиянием без дополнительного буфера (O(log n) памяти на стек рекурсии) с подсчётом инверсий.
+	 * \brief Блоки по kInsertionBlockSize элементов сортируются вставками, затем блоки попарно сливаются функцией rotationMerge.
+	 * \brief Время работы: O(n*log^2(n)) против O(n*log(n)) у mergeSort. На случайных данных примерно в 2-3 раза медленнее mergeSort,
+	 * \brief на почти отсортированных - быстрее, так как уже упорядоченные пары блоков не сливаются.
+	 * \tparam T Тип элементов в массиве.
+	 * \param arrayNumbers Массив элементов.
+	 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Количество инверсий.
+	 */
+	template<typename T>
+	size_t inPlaceMergeSort(std::vector<T>& arrayNumbers, const std::function<bool(const T& lhs, const T& rhs)> less = std::less<T>())
+	{
+		constexpr size_t kInsertionBlockSize = 32;
+		size_t inversionsNumber = 0;
+		const auto size = arrayNumbers.size();
+		for (size_t blockBegin = 0; blockBegin < size; blockBegin += kInsertionBlockSize)
+		{
+			const auto blockEnd = std::min(size, blockBegin + kInsertionBlockSize);
+			for (auto i = blockBegin + 1; i < blockEnd; ++i)
+			{
+				//Каждый сдвиг вставляемого элемента влево - одна инверсия
+				for (auto j = i; j > blockBegin && less(arrayNumbers[j], arrayNumbers[j - 1]); --j)
+				{
+					std::swap(arrayNumbers[j], arrayNumbers[j - 1]);
+					inversionsNumber += 1;
+				}
+			}
+		}
+		for (auto blockSize = kInsertionBlockSize; blockSize < size; blockSize *= 2)
+		{
+			for (size_t blockIterator = 0; blockIterator < size - blockSize; blockIterator += 2 * blockSize)
+			{
+				const auto rightBorder = std::min(size, blockIterator + 2 * blockSize);
+				inversionsNumber += rotationMerge(arrayNumbers, blockIterator, blockIterator + blockSize, rightBorder, less);
+			}
+		}
+		return inversionsNumber;
+	}
 }
 
 
-int main()
+void MergeSortTest_variantsMatchBlockMergeSort()
+{
+	srand(time(nullptr));
+	for (auto test = 0; test < 200; ++test)
+	{
+		std::vector<int32_t> numbers(rand() % 3000);
+		for (auto& number : numbers)
+		{
+			number = rand() % (test + 2);
+		}
+		if (test % 3 == 1)
+		{
+			//Почти отсортированный массив
+			std::sort(numbers.begin(), numbers.end());
+			for (auto i = 0; i < 5 && !numbers.empty(); ++i)
+			{
+				std::swap(numbers[rand() % numbers.size()], numbers[rand() % numbers.size()]);
+			}
+		}
+		else if (test % 3 == 2)
+		{
+			//Чередование возрастающих и убывающих серий
+			for (size_t i = 0; i + 100 <= numbers.size(); i += 100)
+			{
+				std::sort(numbers.begin() + i, numbers.begin() + i + 100);
+				if (i % 200 == 0)
+				{
+					std::reverse(numbers.begin() + i, numbers.begin() + i + 100);
+				}
+			}
+		}
+		auto blockSorted = numbers;
+		auto naturalSorted = numbers;
+		auto inPlaceSorted = numbers;
+		const auto inversionsNumber = custom_algorithms::mergeSort(blockSorted);
+		assert(inversionsNumber == custom_algorithms::naturalMergeSort(naturalSorted));
+		assert(inversionsNumber == custom_algorithms::inPlaceMergeSort(inPlaceSorted));
+		assert(blockSorted == naturalSorted);
+		assert(blockSorted == inPlaceSorted);
+	}
+}
+
+
+void MergeSortBenchmark_inPlaceAgainstBuffered()
+{
+	const size_t n = 1000000;
+	std::mt19937 generator(42);
+	std::vector<int32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = static_cast<int32_t>(generator());
+	}
+	const std::vector<std::pair<std::string, std::function<size_t(std::vector<int32_t>&)>>> sorts = {
+		{ "mergeSort", [](std::vector<int32_t>& array) { return custom_algorithms::mergeSort(array); } },
+		{ "inPlaceMergeSort", [](std::vector<int32_t>& array) { return custom_algorithms::inPlaceMergeSort(array); } },
+	};
+	for (const auto& sort : sorts)
+	{
+		auto array = numbers;
+		const auto start = std::chrono::steady_clock::now();
+		sort.second(array);
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << sort.first << ", n = " << n << ": " << elapsed.count() << " ms" << std::endl;
+	}
+}
+
+
+void SlidingWindowTest_matchesRecomputation()
+{
+	srand(time(nullptr));
+	for (size_t windowSize = 1; windowSize < 40; windowSize += 3)
+	{
+		custom_containers::SlidingWindowInversions<int32_t> window(windowSize);
+		std::vector<int32_t> stream;
+		for (auto i = 0; i < 300; ++i)
+		{
+			stream.push_back(rand() % 20);
+			window.push(stream.back());
+			const auto windowBegin = stream.size() > windowSize ? stream.end() - windowSize : stream.begin();
+			std::vector<int32_t> lastNumbers(windowBegin, stream.end());
+			assert(window.size() == lastNumbers.size());
+			assert(window.inversions() == custom_algorithms::mergeSort(lastNumbers));
+		}
+	}
+}
+
+
+void SlidingWindowBenchmark_compareWithRecomputation()
+{
+	const size_t windowSize = 100000;
+	const size_t ticks = 200;
+	std::vector<int32_t> stream(windowSize + ticks);
+	for (auto& number : stream)
+	{
+		number = rand();
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t recomputedChecksum = 0;
+	for (size_t tick = 0; tick < ticks; ++tick)
+	{
+		std::vector<int32_t> lastNumbers(stream.begin() + tick + 1, stream.begin() + tick + 1 + windowSize);
+		recomputedChecksum += custom_algorithms::mergeSort(lastNumbers);
+	}
+	const std::chrono::duration<double, std::micro> recomputationTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	size_t slidingChecksum = 0;
+	custom_containers::SlidingWindowInversions<int32_t> window(windowSize);
+	for (size_t i = 0; i < stream.size(); ++i)
+	{
+		window.push(stream[i]);
+		if (i >= windowSize)
+		{
+			slidingChecksum += window.inversions();
+		}
+	}
+	const std::chrono::duration<double, std::micro> slidingTime = std::chrono::steady_clock::now() - start;
+
+	assert(recomputedChecksum == slidingChecksum);
+	std::cout << "W = " << windowSize << std::endl;
+	std::cout << "mergeSort per tick: " << recomputationTime.count() / ticks << " us" << std::endl;
+	std::cout << "SlidingWindowInversions per tick: " << slidingTime.count() / stream.size() << " us" << std::endl;
+}
+
+
+void RangeInversionsTest_matchesMergeSort()
+{
+	srand(time(nullptr));
+	std::vector<int32_t> numbers(500);
+	for (auto& number : numbers)
+	{
+		number = rand() % 50;
+	}
+	std::vector<std::pair<size_t, size_t>> queries;
+	for (auto i = 0; i < 2000; ++i)
+	{
+		size_t left = rand() % numbers.size();
+		size_t right = rand() % numbers.size();
+		queries.emplace_back(std::min(left, right), std::max(left, right));
+	}
+	const auto answers = custom_algorithms::countRangeInversions(numbers, queries);
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		std::vector<int32_t> subarray(numbers.begin() + queries[i].first, numbers.begin() + queries[i].second + 1);
+		assert(answers[i] == custom_algorithms::mergeSort(subarray));
+	}
+}
+
+
+void RangeInversionsBenchmark_largeArray()
+{
+	const size_t n = 1000000;
+	const size_t q = 100000;
+	std::mt19937 generator(42);
+	std::vector<int32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = static_cast<int32_t>(generator() % 2000000001) - 1000000000;
+	}
+	std::vector<std::pair<size_t, size_t>> queries;
+	for (size_t i = 0; i < q; ++i)
+	{
+		size_t left = generator() % n;
+		size_t right = generator() % n;
+		queries.emplace_back(std::min(left, right), std::max(left, right));
+	}
+	const auto start = std::chrono::steady_clock::now();
+	const auto answers = custom_algorithms::countRangeInversions(numbers, queries);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "n = " << n << ", Q = " << q << ": " << elapsed.count() << " s" << std::endl;
+}
+
+
+void ApproximateInversionsTest_withinErrorBound()
+{
+	const size_t n = 200000;
+	const auto epsilon = 0.01;
+	const auto delta = 0.001;
+	std::mt19937 generator(7);
+	for (auto swaps : { size_t(0), size_t(100), size_t(10000), n, 10 * n })
+	{
+		//От отсортированного массива к почти случайному
+		std::vector<int32_t> numbers(n);
+		std::iota(numbers.begin(), numbers.end(), 0);
+		for (size_t i = 0; i < swaps; ++i)
+		{
+			std::swap(numbers[generator() % n], numbers[generator() % n]);
+		}
+		custom_algorithms::ApproximateInversionCounter<int32_t> counter(n, epsilon, delta, swaps);
+		for (auto number : numbers)
+		{
+			counter.push(number);
+		}
+		const auto exact = static_cast<double>(custom_algorithms::mergeSort(numbers));
+		const auto pairsNumber = static_cast<double>(n) * (n - 1) / 2;
+		assert(std::abs(counter.inversions() - exact) / pairsNumber <= epsilon);
+	}
+}
+
+
+/**
+ * \brief Чтение последовательности чисел до конца потока, по одному в строке.
+ * \param in Входной поток.
+ * \return Прочитанные числа.
+ */
+std::vector<int32_t> readNumbers(std::istream& in)
 {
 	std::vector<int32_t> numbers;
 	int32_t number{ 0 };
-	while (std::cin >> number)
+	while (in >> number)
 	{
 		numbers.push_back(number);
 	}
+	return numbers;
+}
+
+
+int main()
+{
+	const auto is_test = false;
+	if (is_test)
+	{
+		MergeSortTest_variantsMatchBlockMergeSort();
+		SlidingWindowTest_matchesRecomputation();
+		RangeInversionsTest_matchesMergeSort();
+		ApproximateInversionsTest_withinErrorBound();
+		return 0;
+	}
+	const auto is_benchmark = false;
+	if (is_benchmark)
+	{
+		MergeSortBenchmark_inPlaceAgainstBuffered();
+		SlidingWindowBenchmark_compareWithRecomputation();
+		RangeInversionsBenchmark_largeArray();
+		return 0;
+	}
+
+	auto numbers = readNumbers(std::cin);
 	std::cout << custom_algorithms::mergeSort(numbers);
 }
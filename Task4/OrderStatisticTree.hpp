@@ -0,0 +1,201 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_containers
+{
+	/**
+	 * \brief Точные порядковые статистики растущего потока: вставка и запрос k-й статистики за O(log n).
+	 * \brief Обобщает трекер медианы на двух кучах на произвольный ранг. Элементы хранятся в B+ дереве: листья - отсортированные
+	 * \brief блоки до LEAF_CAPACITY элементов, внутренний узел хранит наименьший элемент и количество элементов каждого поддерева.
+	 * \brief Вставка спускается по элементам-разделителям, k-я статистика - по количествам. Высота дерева при n = 10^6 - три уровня,
+	 * \brief поэтому промахов кеша на операцию много меньше, чем в двоичном дереве поиска.
+	 * \tparam T Тип элементов потока.
+	 */
+	template<typename T>
+	class OrderStatisticTree
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		explicit OrderStatisticTree(const std::function<bool(const T& lhs, const T& rhs)>& less = std::less<T>());
+		~OrderStatisticTree() = default;
+
+		OrderStatisticTree(const OrderStatisticTree& other) = delete;
+		OrderStatisticTree(OrderStatisticTree&& other) noexcept = delete;
+		OrderStatisticTree& operator=(const OrderStatisticTree& other) = delete;
+		OrderStatisticTree& operator=(OrderStatisticTree&& other) noexcept = delete;
+
+		/**
+		 * \brief Добавление элемента потока.
+		 * \param value Добавляемый элемент.
+		 */
+		void insert(const T& value);
+
+		/**
+		 * \brief k-я порядковая статистика среди добавленных элементов.
+		 * \param k Порядок статистики (0..size() - 1).
+		 * \return Элемент, который стоял бы на позиции k в отсортированном массиве добавленных элементов.
+		 */
+		[[nodiscard]] const T& kth(size_t k) const;
+
+		/**
+		 * \brief Нижняя медиана добавленных элементов: статистика порядка (size() - 1) / 2.
+		 */
+		[[nodiscard]] const T& median() const { return kth((size_ - 1) / 2); }
+
+		/**
+		 * \brief Количество добавленных элементов.
+		 */
+		[[nodiscard]] size_t size() const { return size_; }
+
+	private:
+		/**
+		 * \brief Узел дерева. У листа пусты children и sizes, а keys - отсортированные элементы.
+		 * \brief У внутреннего узла keys[i] - наименьший элемент поддерева children[i + 1], sizes[i] - количество элементов поддерева children[i].
+		 */
+		struct Node
+		{
+			std::vector<T> keys;
+			std::vector<uint32_t> children;
+			std::vector<size_t> sizes;
+
+			[[nodiscard]] bool isLeaf() const { return children.empty(); }
+		};
+
+		/**
+		 * \brief Заполнен ли узел: лист - до LEAF_CAPACITY элементов, внутренний узел - до INNER_CAPACITY потомков.
+		 */
+		[[nodiscard]] bool isFull(uint32_t node) const;
+
+		/**
+		 * \brief Делит заполненного потомка с номером child узла parent пополам, вторая половина становится новым потомком child + 1.
+		 */
+		void splitChild(uint32_t parent, size_t child);
+
+		/**
+		 * \brief Максимальное количество элементов в листе.
+		 */
+		static constexpr size_t LEAF_CAPACITY = 256;
+		/**
+		 * \brief Максимальное количество потомков внутреннего узла.
+		 */
+		static constexpr size_t INNER_CAPACITY = 64;
+
+		std::vector<Node> nodes_{ Node() };
+		uint32_t root_{ 0 };
+		size_t size_{ 0 };
+		std::function<bool(const T& lhs, const T& rhs)> less_;
+	};
+
+	template <typename T>
+	OrderStatisticTree<T>::OrderStatisticTree(const std::function<bool(const T& lhs, const T& rhs)>& less) : less_(less)
+	{
+		nodes_[root_].keys.reserve(LEAF_CAPACITY);
+	}
+
+	template <typename T>
+	void OrderStatisticTree<T>::insert(const T& value)
+	{
+		//Заполненные узлы делятся по пути вниз, поэтому деление потомка никогда не переполняет родителя
+		if (isFull(root_))
+		{
+			assert(nodes_.size() < UINT32_MAX);
+			const auto oldRoot = root_;
+			root_ = static_cast<uint32_t>(nodes_.size());
+			nodes_.emplace_back();
+			nodes_[root_].children.push_back(oldRoot);
+			nodes_[root_].sizes.push_back(size_);
+			splitChild(root_, 0);
+		}
+		auto node = root_;
+		while (!nodes_[node].isLeaf())
+		{
+			const auto& keys = nodes_[node].keys;
+			auto child = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), value, less_) - keys.begin());
+			if (isFull(nodes_[node].children[child]))
+			{
+				splitChild(node, child);
+				child += static_cast<size_t>(!less_(value, nodes_[node].keys[child]));
+			}
+			nodes_[node].sizes[child] += 1;
+			node = nodes_[node].children[child];
+		}
+		auto& keys = nodes_[node].keys;
+		keys.insert(std::upper_bound(keys.begin(), keys.end(), value, less_), value);
+		size_ += 1;
+	}
+
+	template <typename T>
+	const T& OrderStatisticTree<T>::kth(size_t k) const
+	{
+		assert(k < size_);
+		auto node = root_;
+		while (!nodes_[node].isLeaf())
+		{
+			const auto& sizes = nodes_[node].sizes;
+			size_t child = 0;
+			while (k >= sizes[child])
+			{
+				k -= sizes[child];
+				child += 1;
+			}
+			node = nodes_[node].children[child];
+		}
+		return nodes_[node].keys[k];
+	}
+
+	template <typename T>
+	bool OrderStatisticTree<T>::isFull(const uint32_t node) const
+	{
+		return nodes_[node].isLeaf() ? nodes_[node].keys.size() == LEAF_CAPACITY : nodes_[node].children.size() == INNER_CAPACITY;
+	}
+
+	template <typename T>
+	void OrderStatisticTree<T>::splitChild(const uint32_t parent, const size_t child)
+	{
+		assert(nodes_.size() < UINT32_MAX);
+		const auto sibling = static_cast<uint32_t>(nodes_.size());
+		nodes_.emplace_back();
+		//Ссылки берутся после emplace_back, поэтому перераспределение памяти массива их не портит
+		auto& left = nodes_[nodes_[parent].children[child]];
+		auto& right = nodes_[sibling];
+		T separator;
+		size_t rightSize = 0;
+		if (left.isLeaf())
+		{
+			const auto half = left.keys.size() / 2;
+			right.keys.reserve(LEAF_CAPACITY);
+			right.keys.assign(std::make_move_iterator(left.keys.begin() + half), std::make_move_iterator(left.keys.end()));
+			left.keys.resize(half);
+			separator = right.keys.front();
+			rightSize = right.keys.size();
+		}
+		else
+		{
+			//Левая половина сохраняет потомков [0, half), правая получает [half, INNER_CAPACITY).
+			//Разделитель между половинами поднимается в родителя.
+			const auto half = left.children.size() / 2;
+			right.children.assign(left.children.begin() + half, left.children.end());
+			right.sizes.assign(left.sizes.begin() + half, left.sizes.end());
+			right.keys.assign(std::make_move_iterator(left.keys.begin() + half), std::make_move_iterator(left.keys.end()));
+			separator = std::move(left.keys[half - 1]);
+			left.children.resize(half);
+			left.sizes.resize(half);
+			left.keys.resize(half - 1);
+			rightSize = std::accumulate(right.sizes.begin(), right.sizes.end(), size_t{ 0 });
+		}
+		auto& parentNode = nodes_[parent];
+		parentNode.children.insert(parentNode.children.begin() + child + 1, sibling);
+		parentNode.keys.insert(parentNode.keys.begin() + child, std::move(separator));
+		parentNode.sizes[child] -= rightSize;
+		parentNode.sizes.insert(parentNode.sizes.begin() + child + 1, rightSize);
+	}
+}
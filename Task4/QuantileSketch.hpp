@@ -0,0 +1,222 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_containers
+{
+	/**
+	 * \brief Потоковый скетч квантилей KLL (Karnin, Lang, Liberty): приближённые порядковые статистики потока при ограниченной памяти.
+	 * \brief Элементы хранятся в компакторах по уровням, элемент уровня h представляет 2^h элементов потока. Переполненный компактор
+	 * \brief сортируется, и в следующий уровень переходит каждый второй его элемент, начиная со случайного из первых двух.
+	 * \brief Ёмкость уровня убывает в COMPACTOR_CAPACITY_RATIO раз с удалением от верхнего, поэтому память: O(k + log(n / k)).
+	 * \brief Погрешность ранга ответа - около 1.7 / k от длины потока с вероятностью 99%. Скетчи можно объединять.
+	 * \tparam T Тип элементов потока.
+	 */
+	template<typename T>
+	class QuantileSketch
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param epsilon Допустимая относительная погрешность ранга. Параметр k выбирается равным ceil(2 / epsilon).
+		 * \param seed Начальное значение генератора случайных чисел.
+		 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		explicit QuantileSketch(double epsilon, uint64_t seed = std::mt19937_64::default_seed, const std::function<bool(const T& lhs, const T& rhs)>& less = std::less<T>());
+		~QuantileSketch() = default;
+
+		QuantileSketch(const QuantileSketch& other) = delete;
+		QuantileSketch(QuantileSketch&& other) noexcept = delete;
+		QuantileSketch& operator=(const QuantileSketch& other) = delete;
+		QuantileSketch& operator=(QuantileSketch&& other) noexcept = delete;
+
+		/**
+		 * \brief Добавление элемента потока.
+		 * \param value Элемент потока.
+		 */
+		void insert(const T& value);
+
+		/**
+		 * \brief Объединение с другим скетчем: результат описывает объединение обоих потоков.
+		 * \param other Скетч с тем же параметром k и той же функцией сравнения. Может быть этим же скетчем: тогда каждый элемент потока учитывается дважды.
+		 */
+		void merge(const QuantileSketch& other);
+
+		/**
+		 * \brief Приближённая квантиль потока.
+		 * \param q Доля от 0 до 1.
+		 * \return Элемент, ранг которого в потоке отличается от q * n не более чем на погрешность скетча.
+		 */
+		[[nodiscard]] T quantile(double q) const;
+
+		/**
+		 * \brief Количество элементов потока.
+		 */
+		[[nodiscard]] uint64_t size() const { return streamLength_; }
+
+		/**
+		 * \brief Количество элементов, хранимых скетчем.
+		 */
+		[[nodiscard]] size_t retainedNumber() const { return retained_; }
+
+	private:
+		/**
+		 * \brief Добавление нового верхнего уровня и пересчёт ёмкостей.
+		 */
+		void grow();
+
+		/**
+		 * \brief Сжатие самого нижнего переполненного компактора. Вызывается, когда скетч хранит больше элементов, чем суммарная ёмкость.
+		 */
+		void compress();
+
+		/**
+		 * \brief Отношение ёмкостей соседних уровней.
+		 */
+		static constexpr double COMPACTOR_CAPACITY_RATIO = 2.0 / 3.0;
+		/**
+		 * \brief Наименьшая ёмкость компактора.
+		 */
+		static constexpr size_t MINIMAL_CAPACITY = 2;
+
+		size_t k_{ 0 };
+		/**
+		 * \brief Компакторы по уровням.
+		 */
+		std::vector<std::vector<T>> compactors_;
+		/**
+		 * \brief Ёмкости компакторов при текущем количестве уровней.
+		 */
+		std::vector<size_t> capacities_;
+		size_t retained_{ 0 };
+		size_t maximalRetained_{ 0 };
+		uint64_t streamLength_{ 0 };
+		std::mt19937_64 generator_;
+		std::function<bool(const T& lhs, const T& rhs)> less_;
+	};
+
+	template <typename T>
+	QuantileSketch<T>::QuantileSketch(const double epsilon, const uint64_t seed, const std::function<bool(const T& lhs, const T& rhs)>& less)
+		: k_(static_cast<size_t>(std::ceil(2 / epsilon))), generator_(seed), less_(less)
+	{
+		assert(epsilon > 0 && epsilon < 1);
+		grow();
+	}
+
+	template <typename T>
+	void QuantileSketch<T>::insert(const T& value)
+	{
+		compactors_.front().push_back(value);
+		retained_ += 1;
+		streamLength_ += 1;
+		if (retained_ >= maximalRetained_)
+		{
+			compress();
+		}
+	}
+
+	template <typename T>
+	void QuantileSketch<T>::merge(const QuantileSketch& other)
+	{
+		assert(k_ == other.k_);
+		//Вставка в вектор диапазона из него же - неопределённое поведение, поэтому при слиянии с самим собой уровни копируются
+		std::vector<std::vector<T>> ownCompactors;
+		if (&other == this)
+		{
+			ownCompactors = compactors_;
+		}
+		const auto& otherCompactors = &other == this ? ownCompactors : other.compactors_;
+		const auto otherRetained = other.retained_;
+		const auto otherLength = other.streamLength_;
+		while (compactors_.size() < otherCompactors.size())
+		{
+			grow();
+		}
+		for (size_t level = 0; level < otherCompactors.size(); ++level)
+		{
+			compactors_[level].insert(compactors_[level].end(), otherCompactors[level].begin(), otherCompactors[level].end());
+		}
+		retained_ += otherRetained;
+		streamLength_ += otherLength;
+		while (retained_ >= maximalRetained_)
+		{
+			compress();
+		}
+	}
+
+	template <typename T>
+	T QuantileSketch<T>::quantile(const double q) const
+	{
+		assert(streamLength_ > 0);
+		//Элементы с весами: элемент уровня h представляет 2^h элементов потока
+		std::vector<std::pair<T, uint64_t>> weighted;
+		weighted.reserve(retained_);
+		for (size_t level = 0; level < compactors_.size(); ++level)
+		{
+			for (const auto& value : compactors_[level])
+			{
+				weighted.emplace_back(value, uint64_t{ 1 } << level);
+			}
+		}
+		std::sort(weighted.begin(), weighted.end(), [this](const std::pair<T, uint64_t>& lhs, const std::pair<T, uint64_t>& rhs) { return less_(lhs.first, rhs.first); });
+		const auto rank = q * static_cast<double>(streamLength_);
+		uint64_t cumulativeWeight = 0;
+		for (const auto& element : weighted)
+		{
+			cumulativeWeight += element.second;
+			if (static_cast<double>(cumulativeWeight) > rank)
+			{
+				return element.first;
+			}
+		}
+		return weighted.back().first;
+	}
+
+	template <typename T>
+	void QuantileSketch<T>::grow()
+	{
+		compactors_.emplace_back();
+		capacities_.resize(compactors_.size());
+		maximalRetained_ = 0;
+		for (size_t level = 0; level < compactors_.size(); ++level)
+		{
+			const auto depth = compactors_.size() - level - 1;
+			capacities_[level] = std::max(MINIMAL_CAPACITY, static_cast<size_t>(std::ceil(k_ * std::pow(COMPACTOR_CAPACITY_RATIO, static_cast<double>(depth)))));
+			maximalRetained_ += capacities_[level];
+		}
+	}
+
+	template <typename T>
+	void QuantileSketch<T>::compress()
+	{
+		for (size_t level = 0; level < compactors_.size(); ++level)
+		{
+			if (compactors_[level].size() < capacities_[level])
+			{
+				continue;
+			}
+			if (level + 1 == compactors_.size())
+			{
+				grow();
+			}
+			auto& compactor = compactors_[level];
+			std::sort(compactor.begin(), compactor.end(), less_);
+			//При нечётном размере последний элемент остаётся на уровне, остальные разбиваются на пары
+			const auto pairsEnd = compactor.size() - compactor.size() % 2;
+			const auto offset = static_cast<size_t>(generator_() & 1);
+			auto& nextCompactor = compactors_[level + 1];
+			for (auto i = offset; i < pairsEnd; i += 2)
+			{
+				nextCompactor.push_back(compactor[i]);
+			}
+			compactor.erase(compactor.begin(), compactor.begin() + pairsEnd);
+			retained_ -= pairsEnd / 2;
+			return;
+		}
+	}
+}
@@ -43,8 +43,13 @@
 
 /*
  *   .
- *  : O(1). 
+ *  .   calculateStatistic: O(log n) -     ,
+ *  ,      .     
+ *   O(n),     - O(n^(2/3))   .
  *   : O(n).
+ *     : O(n).          ,
+ *       (introselect).
+ *      -:  n + min(k, n - k)    3n.
  */
 
 
@@ -52,9 +57,28 @@
 #include <fstream>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <thread>
+#include <memory>
+#include <cstdint>
+#include "QuantileSketch.hpp"
+#include "OrderStatisticTree.hpp"
 
 namespace custom_algorithms
 {
+	/**
+	 * \brief  ,     Less   T    .
+	 * \brief   -   std::less   :       .
+	 * \brief          , ,    .
+	 */
+	template<typename T, typename Less>
+	struct IsBlockPartitionApplicable : std::bool_constant<std::is_arithmetic_v<T> && std::is_same_v<Less, std::less<T>>> {};
+
     /**
      * \brief ,  ,        . 
      */
@@ -63,26 +87,241 @@ namespace custom_algorithms
 	public:
 		/**
 		 * \brief    k-   .
+		 * \brief  T -  ,  less - std::less<T>,        .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param k   .
+		 * \param less    .   true,      .
+		 * \return k-  .
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static size_t calculateStatistic(std::vector<T>& arrayElements, const size_t k, const Less& less = Less());
+
+		/**
+		 * \brief         .
+		 * \brief       ,        ,
+		 * \brief    .  q    O(n log q).
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param ks   ,   .
+		 * \param less    .   true,      .
+		 * \return      ,   ks.
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static std::vector<T> calculateStatistics(std::vector<T>& arrayElements, const std::vector<size_t>& ks, const Less& less = Less());
+
+		/**
+		 * \brief    k-       .
+		 * \brief    ,         ,  
+		 * \brief      ,     ,      ,
+		 * \brief      k- .  ,      
+		 * \brief     .     ,   calculateStatistic.
+		 * \brief  : O(n).
 		 * \tparam T    .
+		 * \tparam Less   .
 		 * \param arrayElements  .
 		 * \param k   .
+		 * \param threadsNumber  .
 		 * \param less    .   true,      .
 		 * \return k-  .
 		 */
+		template<typename T, typename Less = std::less<T>>
+		static size_t calculateStatisticParallel(std::vector<T>& arrayElements, const size_t k, const size_t threadsNumber, const Less& less = Less());
+
+		/**
+		 * \brief    k-        (radix select),  .
+		 * \brief    RADIX_DIGIT_BITS    .    ,   
+		 * \brief  k- ,       :     
+		 * \brief   ,       .    .
+		 * \tparam T     .  -   .
+		 * \param arrayElements  .
+		 * \param k   .
+		 * \return k-  .
+		 */
 		template<typename T>
-		static size_t calculateStatistic(std::vector<T>& arrayElements, const size_t k, const std::function<bool(const T& lhs, const T& rhs)> less = std::less<T>());
+		static T calculateStatisticRadix(const std::vector<T>& arrayElements, size_t k);
+
+		/**
+		 * \brief    k-      .
+		 * \brief         ,      
+		 * \brief k- .   ,      ,    
+		 * \brief       ,    .     : O(n^(2/3)),
+		 * \brief        ,        .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param k   .
+		 * \param less    .   true,      .
+		 * \return k-  .
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static T calculateStatisticConst(const std::vector<T>& arrayElements, size_t k, const Less& less = Less());
+
+		/**
+		 * \brief  :     k     ,  -   .
+		 * \brief  k   n, k           ,    k - 1
+		 * \brief  (k-1)-       .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param k   .
+		 * \param less    .   true,      .
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static void partialSort(std::vector<T>& arrayElements, size_t k, const Less& less = Less());
+
+		/**
+		 * \brief k      .   .
+		 * \brief  k   n,         k  (  O(k)),
+		 * \brief      .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param k   .
+		 * \param less    .   true,      .
+		 * \return k     .
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static std::vector<T> topK(const std::vector<T>& arrayElements, size_t k, const Less& less = Less());
 	private:
+		/**
+		 * \brief ,        lowPivot,      highPivot.
+		 * \brief        ,    ,    
+		 * \brief   ,      .     .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param buffer      .    :   
+		 * \param buffer ,         .
+		 * \param low      .
+		 * \param high      .
+		 * \param lowPivot   .
+		 * \param highPivot    (  lowPivot).
+		 * \param threadsNumber  .
+		 * \param less    .   true,      .
+		 * \return     ,   ,  .
+		 */
+		template<typename T, typename Less>
+		static std::pair<size_t, size_t> partitionParallel(std::vector<T>& arrayElements, T* buffer, const size_t low, const size_t high,
+			const T& lowPivot, const T& highPivot, const size_t threadsNumber, const Less& less);
+
+		/**
+		 * \brief         .    0 - .
+		 * \tparam Function  ,   .
+		 * \param threadsNumber  .
+		 * \param function  .
+		 */
+		template<typename Function>
+		static void runInThreads(const size_t threadsNumber, const Function& function);
+
+		/**
+		 * \brief    ( )      .      .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param heap ,     .
+		 * \param size  .
+		 * \param value  .
+		 * \param less   .   true,      .
+		 */
+		template<typename T, typename Less>
+		static void replaceHeapTop(std::vector<T>& heap, const size_t size, T value, const Less& less);
+
+		/**
+		 * \brief      ,  ,    .
+		 * \brief     PARTITION_BLOCK_SIZE :       ,
+		 * \brief       .       ,
+		 * \brief        .
+		 * \tparam T    .
+		 * \tparam Predicate  .
+		 * \tparam Consumer   .
+		 * \param arrayElements  .
+		 * \param predicate .
+		 * \param consumer  .
+		 */
+		template<typename T, typename Predicate, typename Consumer>
+		static void forEachSelected(const std::vector<T>& arrayElements, const Predicate& predicate, const Consumer& consumer);
+
+		/**
+		 * \brief ,       ,    k- .
+		 * \brief    RADIX_HISTOGRAMS_NUMBER   :       ,
+		 * \brief           .  32-,       L1,
+		 * \brief      RADIX_COUNTERS_CHUNK_SIZE ,    .
+		 * \tparam U    .
+		 * \tparam Digit  ,    .
+		 * \param values  .
+		 * \param size  .
+		 * \param digit ,     ( 2^RADIX_DIGIT_BITS).
+		 * \param k    .        .
+		 * \return       .
+		 */
+		template<typename U, typename Digit>
+		static std::pair<size_t, size_t> findRadixBucket(const U* values, const size_t size, const Digit& digit, size_t& k);
+
+		/**
+		 * \brief ,  k-      .
+		 * \brief    FLOYD_RIVEST_THRESHOLD    -,   - introselect.
+		 * \brief       k     ,  -  .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .
+		 * \param k   ,      (low <= k <= high).
+		 * \param less    .   true,      .
+		 */
+		template<typename T, typename Less>
+		static void selectStatistic(std::vector<T>& arrayElements, size_t low, size_t high, size_t k, const Less& less);
+
 		/**
 		 * \brief ,              .
 		 * \tparam T    .
+		 * \tparam Less   .
 		 * \param arrayElements  .
 		 * \param low      .
 		 * \param high      .
 		 * \param less    .   true,      .
 		 * \return     .
 		 */
-		template<typename T>
-		static size_t partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const std::function<bool(const T& lhs, const T& rhs)>& less);
+		template<typename T, typename Less>
+		static size_t partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief ,              (BlockQuicksort).
+		 * \brief                ,
+		 * \brief       .         .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .       .
+		 * \param less    .   true,      .
+		 * \return     .
+		 */
+		template<typename T, typename Less>
+		static size_t partitionBlock(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief ,        .
+		 * \brief  ,        .
+		 */
+		template<typename T, typename Less>
+		static constexpr bool isBlockPartitionApplicable() { return IsBlockPartitionApplicable<T, Less>::value; }
+
+		/**
+		 * \brief ,      ,     ( ).
+		 * \brief  ,  ,           .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .       .
+		 * \param less    .   true,      .
+		 * \return     ,  ,  .
+		 */
+		template<typename T, typename Less>
+		static std::pair<size_t, size_t> partitionThreeWay(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
 
 		/**
 		 * \brief ,     .
@@ -90,110 +329,1773 @@ namespace custom_algorithms
 		 * \brief          high.
 		 * \brief       low     .
 		 * \tparam T    .
+		 * \tparam Less   .
 		 * \param arrayElements  .
 		 * \param low      .
 		 * \param high      .
 		 * \param less    .   true,      .
 		 */
-		template<typename T>
-		static void selectMainElement(std::vector<T>& arrayElements, size_t low, size_t high, const std::function<bool(const T& lhs, const T& rhs)>& less);
+		template<typename T, typename Less>
+		static void selectMainElement(std::vector<T>& arrayElements, size_t low, size_t high, const Less& less);
+
+		/**
+		 * \brief     :      5 ,      .
+		 * \brief    ,            3/10  .
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .
+		 * \param less    .   true,      .
+		 * \return ,     :      [low, ).
+		 */
+		template<typename T, typename Less>
+		static size_t collectGroupMedians(std::vector<T>& arrayElements, size_t low, size_t high, const Less& less);
+
+		/**
+		 * \brief ,  k-       (introselect).
+		 * \brief     .      , , ,  
+		 * \brief ,    ,  - .   PROGRESS_CHECK_ROUNDS      ,
+		 * \brief      ,       .
+		 * \brief        :   ,   ,    ,
+		 * \brief   O(log n).
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .
+		 * \param k   ,      (low <= k <= high).
+		 * \param less    .   true,      .
+		 * \return      ( k).
+		 */
+		template<typename T, typename Less>
+		static size_t selectPosition(std::vector<T>& arrayElements, size_t low, size_t high, size_t k, const Less& less);
+
+		/**
+		 * \brief ,  k-        -.
+		 * \brief       n^(2/3),    selectPosition ( )  ,
+		 * \brief    ,     .   ,       .
+		 * \brief   PROGRESS_CHECK_ROUNDS     ,    selectPosition.
+		 * \tparam T    .
+		 * \tparam Less   .
+		 * \param arrayElements  .
+		 * \param low      .
+		 * \param high      .
+		 * \param k   ,      (low <= k <= high).
+		 * \param less    .   true,      .
+		 */
+		template<typename T, typename Less>
+		static void floydRivestSelect(std::vector<T>& arrayElements, size_t low, size_t high, size_t k, const Less& less);
+
+		/**
+		 * \brief  ,      -.
+		 * \brief     :   1000   -  introselect,
+		 * \brief         .
+		 */
+		static constexpr size_t FLOYD_RIVEST_THRESHOLD = 1024;
+		/**
+		 * \brief  ,     -    .
+		 */
+		static constexpr size_t FLOYD_RIVEST_SAMPLING_SIZE = 600;
+		/**
+		 * \brief  ,   ,       .
+		 */
+		static constexpr size_t PROGRESS_CHECK_ROUNDS = 3;
+		/**
+		 * \brief      .
+		 */
+		static constexpr size_t MEDIANS_GROUP_SIZE = 5;
+		/**
+		 * \brief     .      uint8_t.
+		 */
+		static constexpr size_t PARTITION_BLOCK_SIZE = 128;
+		/**
+		 * \brief  ,    calculateStatisticParallel   .
+		 */
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 20;
+		/**
+		 * \brief  ,   calculateStatisticParallel   .
+		 */
+		static constexpr size_t PARALLEL_SAMPLE_SIZE = 4096;
+		/**
+		 * \brief            .
+		 * \brief  4      ,       1/16 .
+		 */
+		static constexpr size_t PARALLEL_PIVOT_DISTANCE = 128;
+		/**
+		 * \brief      . RADIX_HISTOGRAMS_NUMBER   2^11  uint32_t  32 
+		 * \brief     L1  (32-48 ).
+		 */
+		static constexpr size_t RADIX_DIGIT_BITS = 11;
+		/**
+		 * \brief  ,     .
+		 */
+		static constexpr size_t RADIX_HISTOGRAMS_NUMBER = 4;
+		/**
+		 * \brief   ,   32-    .
+		 */
+		static constexpr size_t RADIX_COUNTERS_CHUNK_SIZE = UINT32_MAX;
+		/**
+		 * \brief  ,   calculateStatisticConst    .
+		 */
+		static constexpr size_t CONST_SELECTION_THRESHOLD = 4096;
+		/**
+		 * \brief    calculateStatisticConst       ,     .
+		 * \brief          ,      6 .
+		 */
+		static constexpr double CONST_SELECTION_PIVOT_DISTANCE = 3.0;
+		/**
+		 * \brief partialSort  topK  ,  k   n / TOP_K_HEAP_RATIO.
+		 */
+		static constexpr size_t TOP_K_HEAP_RATIO = 4096;
 	};
 
 
 
-    template <typename T>
-    size_t custom_algorithms::QuickSort::calculateStatistic(std::vector<T>& arrayElements, const size_t k, const std::function<bool(const T& lhs, const T& rhs)> less)
+    template <typename T, typename Less>
+    size_t custom_algorithms::QuickSort::calculateStatistic(std::vector<T>& arrayElements, const size_t k, const Less& less)
+    {
+        selectStatistic(arrayElements, 0, arrayElements.size() - 1, k, less);
+        return arrayElements[k];
+    }
+
+
+
+    template <typename T, typename Less>
+    std::vector<T> QuickSort::calculateStatistics(std::vector<T>& arrayElements, const std::vector<size_t>& ks, const Less& less)
     {
-        size_t currentMainElementPosition = arrayElements.size();
-        size_t leftBorder = 0;
-        size_t rightBorder = arrayElements.size() - 1;
+        assert(std::is_sorted(ks.begin(), ks.end()));
         /*
-         *       < k, 
-         *        ,  - .
-         * ,     k-  .
+         *       [ksBegin, ksEnd)  ,   .
+         *      :      ,  -  .
+         *           .
          */
-        while (currentMainElementPosition != k)
+        struct Segment
+        {
+            size_t low;
+            size_t high;
+            size_t ksBegin;
+            size_t ksEnd;
+        };
+        std::vector<Segment> segments;
+        if (!ks.empty())
+        {
+            segments.push_back({ 0, arrayElements.size() - 1, 0, ks.size() });
+        }
+        while (!segments.empty())
+        {
+            const auto segment = segments.back();
+            segments.pop_back();
+            const auto k = ks[segment.ksBegin + (segment.ksEnd - segment.ksBegin) / 2];
+            selectStatistic(arrayElements, segment.low, segment.high, k, less);
+            const auto leftEnd = static_cast<size_t>(std::lower_bound(ks.begin() + segment.ksBegin, ks.begin() + segment.ksEnd, k) - ks.begin());
+            const auto rightBegin = static_cast<size_t>(std::upper_bound(ks.begin() + segment.ksBegin, ks.begin() + segment.ksEnd, k) - ks.begin());
+            if (segment.ksBegin < leftEnd)
+            {
+                segments.push_back({ segment.low, k - 1, segment.ksBegin, leftEnd });
+            }
+            if (rightBegin < segment.ksEnd)
+            {
+                segments.push_back({ k + 1, segment.high, rightBegin, segment.ksEnd });
+            }
+        }
+        std::vector<T> statistics;
+        statistics.reserve(ks.size());
+        for (const auto k : ks)
+        {
+            statistics.push_back(arrayElements[k]);
+        }
+        return statistics;
+    }
+
+
+
+    template <typename T, typename Less>
+    size_t QuickSort::calculateStatisticParallel(std::vector<T>& arrayElements, const size_t k, const size_t threadsNumber, const Less& less)
+    {
+        assert(threadsNumber > 0);
+        size_t low = 0;
+        size_t high = arrayElements.size() - 1;
+        std::unique_ptr<T[]> buffer;
+        while (threadsNumber > 1 && high - low + 1 >= PARALLEL_THRESHOLD)
         {
-            if (currentMainElementPosition > k)
+            //    ,      
+            const auto size = high - low + 1;
+            const auto step = size / PARALLEL_SAMPLE_SIZE;
+            std::vector<T> sample(PARALLEL_SAMPLE_SIZE);
+            for (size_t i = 0; i < PARALLEL_SAMPLE_SIZE; ++i)
+            {
+                sample[i] = arrayElements[low + i * step];
+            }
+            std::sort(sample.begin(), sample.end(), less);
+            const auto rank = static_cast<size_t>(static_cast<double>(k - low) / static_cast<double>(size) * PARALLEL_SAMPLE_SIZE);
+            const auto lowPivot = sample[rank > PARALLEL_PIVOT_DISTANCE ? rank - PARALLEL_PIVOT_DISTANCE : 0];
+            const auto highPivot = sample[std::min(rank + PARALLEL_PIVOT_DISTANCE, PARALLEL_SAMPLE_SIZE - 1)];
+
+            if (!buffer)
+            {
+                buffer.reset(new T[size]);
+            }
+            const auto middle = partitionParallel(arrayElements, buffer.get(), low, high, lowPivot, highPivot, threadsNumber, less);
+            if (k < middle.first)
+            {
+                high = middle.first - 1;
+            }
+            else if (k > middle.second)
             {
-                rightBorder = currentMainElementPosition - 1;
-                selectMainElement(arrayElements, leftBorder, rightBorder, less);
-                currentMainElementPosition = partition(arrayElements, leftBorder, rightBorder, less);
+                low = middle.second + 1;
             }
             else
             {
-                leftBorder = currentMainElementPosition + 1;
-                selectMainElement(arrayElements, leftBorder, rightBorder, less);
-                currentMainElementPosition = partition(arrayElements, leftBorder, rightBorder, less);
+                //   ,      k- 
+                if (!less(lowPivot, highPivot))
+                {
+                    return arrayElements[k];
+                }
+                low = middle.first;
+                high = middle.second;
+            }
+            //      ,   ,    
+            if (high - low + 1 == size)
+            {
+                break;
             }
         }
-        return arrayElements[currentMainElementPosition];
+        selectStatistic(arrayElements, low, high, k, less);
+        return arrayElements[k];
     }
 
 
 
-    template <typename T>
-    size_t QuickSort::partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const std::function<bool(const T& lhs, const T& rhs)>& less)
+    template <typename T, typename Less>
+    T QuickSort::calculateStatisticConst(const std::vector<T>& arrayElements, size_t k, const Less& less)
     {
-        /*
-         *    Partition     ,   . 
-         *   ,   . 
-         *      . 
-         *    .
-         *  () i     ,   .
-         *  j  i,  j     .
-         *  .  ,    j.    ,   j.
-         *     ,   a[i]  a[j] ,  i   j.
-         *        ,     i.
-         */
+        assert(k < arrayElements.size());
+        const auto size = arrayElements.size();
+        if (size < CONST_SELECTION_THRESHOLD)
+        {
+            auto copy = arrayElements;
+            selectStatistic(copy, 0, size - 1, k, less);
+            return copy[k];
+        }
 
-        auto leftIterator = low;
-        while (!less(arrayElements[high], arrayElements[leftIterator]) && (leftIterator < high))
+        //   n^(2/3) / 2   ,     
+        const auto sampleSize = static_cast<size_t>(0.5 * std::pow(static_cast<double>(size), 2.0 / 3.0));
+        //    :  minstd_rand   2^31,     
+        std::mt19937_64 generator(size);
+        std::uniform_int_distribution<size_t> position(0, size - 1);
+        std::vector<T> sample(sampleSize);
+        for (auto& element : sample)
         {
-            leftIterator += 1;
+            element = arrayElements[position(generator)];
         }
-        if (leftIterator == high)
+        const auto rank = static_cast<double>(k) / static_cast<double>(size) * static_cast<double>(sampleSize);
+        const auto distance = CONST_SELECTION_PIVOT_DISTANCE * std::sqrt(static_cast<double>(sampleSize));
+        const auto pivots = calculateStatistics(sample, {
+            static_cast<size_t>(std::max(0.0, rank - distance)),
+            std::min(sampleSize - 1, static_cast<size_t>(rank + distance)) }, less);
+        const auto lowPivot = pivots[0];
+        const auto highPivot = pivots[1];
+        const auto equalPivots = !less(lowPivot, highPivot);
+        sample.clear();
+        sample.shrink_to_fit();
+
+        //   :    lowPivot   highPivot
+        size_t lessNumber = 0;
+        size_t greaterNumber = 0;
+        for (const auto& element : arrayElements)
         {
-            return high;
+            lessNumber += less(element, lowPivot);
+            greaterNumber += less(highPivot, element);
         }
 
-        for (auto rightIterator = leftIterator + 1; rightIterator < high; ++rightIterator)
+        //   ,    .     .
+        std::vector<T> candidates;
+        if (k < lessNumber)
         {
-            if (!less(arrayElements[high], arrayElements[rightIterator]))
+            candidates.reserve(lessNumber);
+            forEachSelected(arrayElements, [&less, &lowPivot](const T& element) { return less(element, lowPivot); },
+                [&candidates](const T& element) { candidates.push_back(element); });
+        }
+        else if (k >= size - greaterNumber)
+        {
+            candidates.reserve(greaterNumber);
+            forEachSelected(arrayElements, [&less, &highPivot](const T& element) { return less(highPivot, element); },
+                [&candidates](const T& element) { candidates.push_back(element); });
+            k -= size - greaterNumber;
+        }
+        else
+        {
+            if (equalPivots)
             {
-                std::swap(arrayElements[leftIterator], arrayElements[rightIterator]);
-                leftIterator += 1;
+                return lowPivot;
+            }
+            //    :         
+            size_t lowEqualNumber = 0;
+            size_t highEqualNumber = 0;
+            forEachSelected(arrayElements, [&less, &lowPivot, &highPivot](const T& element) { return static_cast<int>(!less(element, lowPivot)) & static_cast<int>(!less(highPivot, element)); },
+                [&](const T& element)
+            {
+                if (!less(lowPivot, element))
+                {
+                    lowEqualNumber += 1;
+                }
+                else if (!less(element, highPivot))
+                {
+                    highEqualNumber += 1;
+                }
+                else
+                {
+                    candidates.push_back(element);
+                }
+            });
+            if (k < lessNumber + lowEqualNumber)
+            {
+                return lowPivot;
+            }
+            if (k >= size - greaterNumber - highEqualNumber)
+            {
+                return highPivot;
             }
+            k -= lessNumber + lowEqualNumber;
         }
-        std::swap(arrayElements[leftIterator], arrayElements[high]);
-        return leftIterator;
+        selectStatistic(candidates, 0, candidates.size() - 1, k, less);
+        return candidates[k];
     }
 
 
 
-    template <typename T>
-    void QuickSort::selectMainElement(std::vector<T>& arrayElements, size_t low, size_t high, const std::function<bool(const T& lhs, const T& rhs)>& less)
+    template <typename T, typename Less>
+    void QuickSort::partialSort(std::vector<T>& arrayElements, size_t k, const Less& less)
     {
-        auto mid = (low + high) / 2;
-        if (less(arrayElements[mid], arrayElements[low]))
+        k = std::min(k, arrayElements.size());
+        if (k == 0)
         {
-            std::swap(arrayElements[mid], arrayElements[low]);
+            return;
         }
-        if (less(arrayElements[high], arrayElements[low]))
+        if (k <= arrayElements.size() / TOP_K_HEAP_RATIO)
         {
-            std::swap(arrayElements[high], arrayElements[low]);
+            //   -      .     ,      .
+            std::make_heap(arrayElements.begin(), arrayElements.begin() + k, less);
+            for (auto i = k; i < arrayElements.size(); ++i)
+            {
+                if (less(arrayElements[i], arrayElements.front()))
+                {
+                    auto value = std::move(arrayElements[i]);
+                    arrayElements[i] = std::move(arrayElements.front());
+                    replaceHeapTop(arrayElements, k, std::move(value), less);
+                }
+            }
+            std::sort_heap(arrayElements.begin(), arrayElements.begin() + k, less);
+            return;
         }
-        if (less(arrayElements[mid], arrayElements[high]))
+        if (k < arrayElements.size())
         {
-            std::swap(arrayElements[mid], arrayElements[high]);
+            selectStatistic(arrayElements, 0, arrayElements.size() - 1, k - 1, less);
         }
+        std::sort(arrayElements.begin(), arrayElements.begin() + k, less);
     }
-}
 
 
 
-int main()
-{
+    template <typename T, typename Less>
+    std::vector<T> QuickSort::topK(const std::vector<T>& arrayElements, size_t k, const Less& less)
+    {
+        k = std::min(k, arrayElements.size());
+        if (k == 0)
+        {
+            return {};
+        }
+        if (k > arrayElements.size() / TOP_K_HEAP_RATIO)
+        {
+            auto copy = arrayElements;
+            partialSort(copy, k, less);
+            copy.resize(k);
+            return copy;
+        }
+        std::vector<T> heap(arrayElements.begin(), arrayElements.begin() + k);
+        std::make_heap(heap.begin(), heap.end(), less);
+        for (auto i = k; i < arrayElements.size(); ++i)
+        {
+            if (less(arrayElements[i], heap.front()))
+            {
+                replaceHeapTop(heap, k, arrayElements[i], less);
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end(), less);
+        return heap;
+    }
+
+
+
+    template <typename T, typename Less>
+    std::pair<size_t, size_t> QuickSort::partitionParallel(std::vector<T>& arrayElements, T* buffer, const size_t low, const size_t high,
+        const T& lowPivot, const T& highPivot, const size_t threadsNumber, const Less& less)
+    {
+        const auto size = high - low + 1;
+        const auto chunkSize = (size + threadsNumber - 1) / threadsNumber;
+        //         
+        std::vector<size_t> lessNumbers(threadsNumber, 0);
+        std::vector<size_t> greaterNumbers(threadsNumber, 0);
+        runInThreads(threadsNumber, [&](const size_t thread)
+        {
+            const auto begin = low + std::min(size, thread * chunkSize);
+            const auto end = low + std::min(size, (thread + 1) * chunkSize);
+            size_t lessNumber = 0;
+            size_t greaterNumber = 0;
+            for (auto i = begin; i < end; ++i)
+            {
+                lessNumber += less(arrayElements[i], lowPivot);
+                greaterNumber += less(highPivot, arrayElements[i]);
+            }
+            lessNumbers[thread] = lessNumber;
+            greaterNumbers[thread] = greaterNumber;
+        });
+
+        // :   ,        
+        std::vector<size_t> lessOffsets(threadsNumber);
+        std::vector<size_t> middleOffsets(threadsNumber);
+        std::vector<size_t> greaterOffsets(threadsNumber);
+        size_t lessTotal = 0;
+        size_t greaterTotal = 0;
+        for (size_t thread = 0; thread < threadsNumber; ++thread)
+        {
+            lessOffsets[thread] = lessTotal;
+            greaterOffsets[thread] = greaterTotal;
+            lessTotal += lessNumbers[thread];
+            greaterTotal += greaterNumbers[thread];
+        }
+        const auto middleTotal = size - lessTotal - greaterTotal;
+        size_t middleOffset = lessTotal;
+        for (size_t thread = 0; thread < threadsNumber; ++thread)
+        {
+            const auto chunkLength = std::min(size, (thread + 1) * chunkSize) - std::min(size, thread * chunkSize);
+            middleOffsets[thread] = middleOffset;
+            middleOffset += chunkLength - lessNumbers[thread] - greaterNumbers[thread];
+            greaterOffsets[thread] += lessTotal + middleTotal;
+        }
+
+        runInThreads(threadsNumber, [&](const size_t thread)
+        {
+            const auto begin = low + std::min(size, thread * chunkSize);
+            const auto end = low + std::min(size, (thread + 1) * chunkSize);
+            //    : 0 - , 1 -   , 2 - 
+            size_t positions[3] = { lessOffsets[thread], middleOffsets[thread], greaterOffsets[thread] };
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto part = 1 + static_cast<size_t>(less(highPivot, arrayElements[i])) - static_cast<size_t>(less(arrayElements[i], lowPivot));
+                buffer[positions[part]++] = std::move(arrayElements[i]);
+            }
+        });
+        runInThreads(threadsNumber, [&](const size_t thread)
+        {
+            const auto begin = std::min(size, thread * chunkSize);
+            const auto end = std::min(size, (thread + 1) * chunkSize);
+            std::move(buffer + begin, buffer + end, arrayElements.begin() + low + begin);
+        });
+        return { low + lessTotal, low + lessTotal + middleTotal - 1 };
+    }
+
+
+
+    template <typename T>
+    T QuickSort::calculateStatisticRadix(const std::vector<T>& arrayElements, size_t k)
+    {
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Radix select requires an integral type");
+        using Key = std::make_unsigned_t<T>;
+        assert(k < arrayElements.size());
+        //     ,       
+        constexpr auto signMask = std::is_signed_v<T> ? static_cast<Key>(Key{ 1 } << (8 * sizeof(Key) - 1)) : Key{ 0 };
+        //     ,      RADIX_DIGIT_BITS:      
+        constexpr auto firstShift = 8 * sizeof(Key) > RADIX_DIGIT_BITS ? 8 * sizeof(Key) - RADIX_DIGIT_BITS : 0;
+        constexpr auto digitMask = (size_t{ 1 } << RADIX_DIGIT_BITS) - 1;
+        auto shift = firstShift;
+
+        //       ,     .
+        //     ,       .
+        const auto firstDigit = [](const T element) { return static_cast<size_t>(static_cast<Key>(static_cast<Key>(element) ^ signMask) >> firstShift) & digitMask; };
+        const auto firstBucket = findRadixBucket(arrayElements.data(), arrayElements.size(), firstDigit, k);
+        std::vector<Key> candidates;
+        candidates.reserve(firstBucket.second);
+        for (const auto& element : arrayElements)
+        {
+            if (firstDigit(element) == firstBucket.first)
+            {
+                candidates.push_back(static_cast<Key>(static_cast<Key>(element) ^ signMask));
+            }
+        }
+        auto prefix = static_cast<Key>(static_cast<Key>(firstBucket.first) << shift);
+
+        while (candidates.size() > 1 && shift > 0)
+        {
+            shift = shift > RADIX_DIGIT_BITS ? shift - RADIX_DIGIT_BITS : 0;
+            const auto bucket = findRadixBucket(candidates.data(), candidates.size(), [shift](const Key key) { return static_cast<size_t>(key >> shift) & digitMask; }, k);
+            prefix |= static_cast<Key>(static_cast<Key>(bucket.first) << shift);
+            //  :   ,   ,    
+            const auto mask = static_cast<Key>(~uint64_t{ 0 } << shift);
+            size_t candidatesNumber = 0;
+            for (const auto key : candidates)
+            {
+                candidates[candidatesNumber] = key;
+                candidatesNumber += static_cast<size_t>((key & mask) == prefix);
+            }
+            candidates.resize(candidatesNumber);
+        }
+        //     prefix -  ,    
+        const auto key = shift == 0 ? prefix : candidates.front();
+        return static_cast<T>(key ^ signMask);
+    }
+
+
+
+    template <typename U, typename Digit>
+    std::pair<size_t, size_t> QuickSort::findRadixBucket(const U* values, const size_t size, const Digit& digit, size_t& k)
+    {
+        constexpr size_t bucketsNumber = size_t{ 1 } << RADIX_DIGIT_BITS;
+        std::vector<uint32_t> histograms(RADIX_HISTOGRAMS_NUMBER * bucketsNumber);
+        std::vector<size_t> bucketsSizes(bucketsNumber, 0);
+        for (size_t chunkBegin = 0; chunkBegin < size; chunkBegin += RADIX_COUNTERS_CHUNK_SIZE)
+        {
+            const auto chunkEnd = std::min(size, chunkBegin + RADIX_COUNTERS_CHUNK_SIZE);
+            std::fill(histograms.begin(), histograms.end(), 0);
+            auto i = chunkBegin;
+            for (; i + RADIX_HISTOGRAMS_NUMBER <= chunkEnd; i += RADIX_HISTOGRAMS_NUMBER)
+            {
+                for (size_t table = 0; table < RADIX_HISTOGRAMS_NUMBER; ++table)
+                {
+                    histograms[table * bucketsNumber + digit(values[i + table])] += 1;
+                }
+            }
+            for (; i < chunkEnd; ++i)
+            {
+                histograms[digit(values[i])] += 1;
+            }
+            for (size_t bucket = 0; bucket < bucketsNumber; ++bucket)
+            {
+                for (size_t table = 0; table < RADIX_HISTOGRAMS_NUMBER; ++table)
+                {
+                    bucketsSizes[bucket] += histograms[table * bucketsNumber + bucket];
+                }
+            }
+        }
+        for (size_t bucket = 0; bucket < bucketsNumber; ++bucket)
+        {
+            if (k < bucketsSizes[bucket])
+            {
+                return { bucket, bucketsSizes[bucket] };
+            }
+            k -= bucketsSizes[bucket];
+        }
+        assert(false);
+        return { 0, 0 };
+    }
+
+
+
+    template <typename T, typename Less>
+    void QuickSort::replaceHeapTop(std::vector<T>& heap, const size_t size, T value, const Less& less)
+    {
+        size_t position = 0;
+        while (2 * position + 1 < size)
+        {
+            auto child = 2 * position + 1;
+            if (child + 1 < size && less(heap[child], heap[child + 1]))
+            {
+                child += 1;
+            }
+            if (!less(value, heap[child]))
+            {
+                break;
+            }
+            heap[position] = std::move(heap[child]);
+            position = child;
+        }
+        heap[position] = std::move(value);
+    }
+
+
+
+    template <typename T, typename Predicate, typename Consumer>
+    void QuickSort::forEachSelected(const std::vector<T>& arrayElements, const Predicate& predicate, const Consumer& consumer)
+    {
+        std::vector<T> block(PARTITION_BLOCK_SIZE);
+        for (size_t begin = 0; begin < arrayElements.size(); begin += PARTITION_BLOCK_SIZE)
+        {
+            const auto end = std::min(arrayElements.size(), begin + PARTITION_BLOCK_SIZE);
+            size_t selectedNumber = 0;
+            for (auto i = begin; i < end; ++i)
+            {
+                block[selectedNumber] = arrayElements[i];
+                selectedNumber += static_cast<size_t>(predicate(arrayElements[i]));
+            }
+            for (size_t i = 0; i < selectedNumber; ++i)
+            {
+                consumer(block[i]);
+            }
+        }
+    }
+
+
+
+    template <typename Function>
+    void QuickSort::runInThreads(const size_t threadsNumber, const Function& function)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(threadsNumber - 1);
+        for (size_t thread = 1; thread < threadsNumber; ++thread)
+        {
+            threads.emplace_back(function, thread);
+        }
+        function(0);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+
+
+    template <typename T, typename Less>
+    void QuickSort::selectStatistic(std::vector<T>& arrayElements, const size_t low, const size_t high, const size_t k, const Less& less)
+    {
+        if (high - low + 1 >= FLOYD_RIVEST_THRESHOLD)
+        {
+            floydRivestSelect(arrayElements, low, high, k, less);
+        }
+        else
+        {
+            selectPosition(arrayElements, low, high, k, less);
+        }
+    }
+
+
+
+    template <typename T, typename Less>
+    void QuickSort::floydRivestSelect(std::vector<T>& arrayElements, size_t low, size_t high, const size_t k, const Less& less)
+    {
+        //      , ,    selectPosition, ,
+        //  PROGRESS_CHECK_ROUNDS      ,    introselect
+        auto sizeAtCheck = high - low + 1;
+        // :        (    
+        //calculateStatisticParallel   ).         
+        std::mt19937_64 generator(high - low + 1);
+        for (size_t round = 0; low < high; ++round)
+        {
+            if (round != 0 && round % PROGRESS_CHECK_ROUNDS == 0)
+            {
+                if (2 * (high - low + 1) > sizeAtCheck)
+                {
+                    selectPosition(arrayElements, low, high, k, less);
+                    return;
+                }
+                sizeAtCheck = high - low + 1;
+            }
+            if (high - low > FLOYD_RIVEST_SAMPLING_SIZE)
+            {
+                //   ,  k-        
+                const auto size = static_cast<double>(high - low + 1);
+                const auto rank = static_cast<double>(k - low + 1);
+                const auto logSize = std::log(size);
+                const auto sampleSize = 0.5 * std::exp(2 * logSize / 3);
+                auto deviation = 0.5 * std::sqrt(logSize * sampleSize * (size - sampleSize) / size);
+                if (rank < size / 2)
+                {
+                    deviation = -deviation;
+                }
+                const auto sampleLow = std::max(low, static_cast<size_t>(std::max(0.0, static_cast<double>(k) - rank * sampleSize / size + deviation)));
+                const auto sampleHigh = std::min(high, static_cast<size_t>(std::max(0.0, static_cast<double>(k) + (size - rank) * sampleSize / size + deviation)));
+                //      (,  ),    k
+                //   .        .
+                //    :  minstd_rand   2^31,     
+                std::uniform_int_distribution<size_t> position(low, high);
+                for (auto i = sampleLow; i <= sampleHigh; ++i)
+                {
+                    std::swap(arrayElements[i], arrayElements[position(generator)]);
+                }
+                //   :      
+                selectPosition(arrayElements, sampleLow, sampleHigh, k, less);
+            }
+
+            size_t rightIterator = 0;
+            if constexpr (isBlockPartitionApplicable<T, Less>())
+            {
+                std::swap(arrayElements[k], arrayElements[high]);
+                rightIterator = partitionBlock(arrayElements, low, high, less);
+            }
+            else
+            {
+                //   ,    k.
+                //       ,     - ,    .
+                const auto pivot = arrayElements[k];
+                std::swap(arrayElements[low], arrayElements[k]);
+                if (less(pivot, arrayElements[high]))
+                {
+                    std::swap(arrayElements[low], arrayElements[high]);
+                }
+                auto leftIterator = low;
+                rightIterator = high;
+                while (leftIterator < rightIterator)
+                {
+                    std::swap(arrayElements[leftIterator], arrayElements[rightIterator]);
+                    leftIterator += 1;
+                    rightIterator -= 1;
+                    while (less(arrayElements[leftIterator], pivot))
+                    {
+                        leftIterator += 1;
+                    }
+                    while (less(pivot, arrayElements[rightIterator]))
+                    {
+                        rightIterator -= 1;
+                    }
+                }
+                //       rightIterator
+                if (!less(arrayElements[low], pivot) && !less(pivot, arrayElements[low]))
+                {
+                    std::swap(arrayElements[low], arrayElements[rightIterator]);
+                }
+                else
+                {
+                    rightIterator += 1;
+                    std::swap(arrayElements[rightIterator], arrayElements[high]);
+                }
+            }
+            if (rightIterator == k)
+            {
+                return;
+            }
+            if (rightIterator < k)
+            {
+                low = rightIterator + 1;
+            }
+            else
+            {
+                high = rightIterator - 1;
+            }
+        }
+    }
+
+
+
+    template <typename T, typename Less>
+    size_t QuickSort::selectPosition(std::vector<T>& arrayElements, const size_t low, const size_t high, const size_t k, const Less& less)
+    {
+        /*
+         *  k-    [low, high].      ,   
+         *      ,       .
+         */
+        struct Search
+        {
+            size_t low;
+            size_t high;
+            size_t k;
+            bool useMedianOfMedians;
+            size_t roundsAfterCheck;
+            size_t sizeAtCheck;
+        };
+        std::vector<Search> searches{ { low, high, k, false, 0, high - low + 1 } };
+        //   .    ,        
+        size_t found = k;
+        auto isMedianFound = false;
+        while (!searches.empty())
+        {
+            auto& search = searches.back();
+            /*
+             *    k      ,  .
+             *        ,  k  ,  .
+             * ,     k-  .
+             */
+            if (search.low >= search.high)
+            {
+                found = search.low;
+                isMedianFound = true;
+                searches.pop_back();
+                continue;
+            }
+            //   ,   ,        .
+            //      :         .
+            auto threeWay = true;
+            if (search.useMedianOfMedians)
+            {
+                if (!isMedianFound)
+                {
+                    const auto mediansEnd = collectGroupMedians(arrayElements, search.low, search.high, less);
+                    const auto mediansSize = mediansEnd - search.low;
+                    searches.push_back({ search.low, mediansEnd - 1, search.low + (mediansSize - 1) / 2, false, 0, mediansSize });
+                    continue;
+                }
+                std::swap(arrayElements[found], arrayElements[search.high]);
+                isMedianFound = false;
+            }
+            else
+            {
+                selectMainElement(arrayElements, search.low, search.high, less);
+                const auto mid = (search.low + search.high) / 2;
+                threeWay = !less(arrayElements[search.low], arrayElements[search.high]) || !less(arrayElements[search.high], arrayElements[mid]);
+            }
+            std::pair<size_t, size_t> equalRange;
+            if (threeWay)
+            {
+                equalRange = partitionThreeWay(arrayElements, search.low, search.high, less);
+            }
+            else
+            {
+                size_t currentMainElementPosition = 0;
+                if constexpr (isBlockPartitionApplicable<T, Less>())
+                {
+                    currentMainElementPosition = partitionBlock(arrayElements, search.low, search.high, less);
+                }
+                else
+                {
+                    currentMainElementPosition = partition(arrayElements, search.low, search.high, less);
+                }
+                equalRange = { currentMainElementPosition, currentMainElementPosition };
+            }
+            if (equalRange.first <= search.k && search.k <= equalRange.second)
+            {
+                found = search.k;
+                isMedianFound = true;
+                searches.pop_back();
+                continue;
+            }
+            if (search.k < equalRange.first)
+            {
+                search.high = equalRange.first - 1;
+            }
+            else
+            {
+                search.low = equalRange.second + 1;
+            }
+
+            //    :           
+            if (!search.useMedianOfMedians && ++search.roundsAfterCheck == PROGRESS_CHECK_ROUNDS)
+            {
+                search.useMedianOfMedians = 2 * (search.high - search.low + 1) > search.sizeAtCheck;
+                search.sizeAtCheck = search.high - search.low + 1;
+                search.roundsAfterCheck = 0;
+            }
+        }
+        return found;
+    }
+
+
+
+    template <typename T, typename Less>
+    size_t QuickSort::collectGroupMedians(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+    {
+        //          
+        auto mediansEnd = low;
+        for (auto groupBegin = low; groupBegin <= high; groupBegin += MEDIANS_GROUP_SIZE)
+        {
+            const auto groupEnd = std::min(groupBegin + MEDIANS_GROUP_SIZE - 1, high);
+            for (auto i = groupBegin + 1; i <= groupEnd; ++i)
+            {
+                for (auto j = i; j > groupBegin && less(arrayElements[j], arrayElements[j - 1]); --j)
+                {
+                    std::swap(arrayElements[j], arrayElements[j - 1]);
+                }
+            }
+            std::swap(arrayElements[mediansEnd], arrayElements[(groupBegin + groupEnd) / 2]);
+            mediansEnd += 1;
+        }
+        return mediansEnd;
+    }
+
+
+
+    template <typename T, typename Less>
+    size_t QuickSort::partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+    {
+        /*
+         *    Partition     ,   . 
+         *   ,   . 
+         *      . 
+         *    .
+         *  () i     ,   .
+         *  j  i,  j     .
+         *  .  ,    j.    ,   j.
+         *     ,   a[i]  a[j] ,  i   j.
+         *        ,     i.
+         */
+
+        auto leftIterator = low;
+        while (!less(arrayElements[high], arrayElements[leftIterator]) && (leftIterator < high))
+        {
+            leftIterator += 1;
+        }
+        if (leftIterator == high)
+        {
+            return high;
+        }
+
+        for (auto rightIterator = leftIterator + 1; rightIterator < high; ++rightIterator)
+        {
+            if (!less(arrayElements[high], arrayElements[rightIterator]))
+            {
+                std::swap(arrayElements[leftIterator], arrayElements[rightIterator]);
+                leftIterator += 1;
+            }
+        }
+        std::swap(arrayElements[leftIterator], arrayElements[high]);
+        return leftIterator;
+    }
+
+
+
+    template <typename T, typename Less>
+    size_t QuickSort::partitionBlock(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+    {
+        /*
+         *   [low, high - 1]:      ,  -  .
+         *    [leftIterator, rightEnd)     ,      
+         *   ,     .    :   ,
+         *      .         .
+         * ,     ,  .    .
+         */
+        const auto pivot = arrayElements[high];
+        uint8_t leftOffsets[PARTITION_BLOCK_SIZE];
+        uint8_t rightOffsets[PARTITION_BLOCK_SIZE];
+        size_t leftNumber = 0;
+        size_t rightNumber = 0;
+        size_t leftStart = 0;
+        size_t rightStart = 0;
+        auto leftIterator = low;
+        auto rightEnd = high;
+        while (rightEnd - leftIterator >= 2 * PARTITION_BLOCK_SIZE)
+        {
+            if (leftNumber == 0)
+            {
+                leftStart = 0;
+                for (size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+                {
+                    leftOffsets[leftNumber] = static_cast<uint8_t>(i);
+                    leftNumber += !less(arrayElements[leftIterator + i], pivot);
+                }
+            }
+            if (rightNumber == 0)
+            {
+                rightStart = 0;
+                for (size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+                {
+                    rightOffsets[rightNumber] = static_cast<uint8_t>(i);
+                    rightNumber += !less(pivot, arrayElements[rightEnd - 1 - i]);
+                }
+            }
+            const auto swapsNumber = std::min(leftNumber, rightNumber);
+            for (size_t i = 0; i < swapsNumber; ++i)
+            {
+                std::swap(arrayElements[leftIterator + leftOffsets[leftStart + i]], arrayElements[rightEnd - 1 - rightOffsets[rightStart + i]]);
+            }
+            leftNumber -= swapsNumber;
+            rightNumber -= swapsNumber;
+            leftStart += swapsNumber;
+            rightStart += swapsNumber;
+            if (leftNumber == 0)
+            {
+                leftIterator += PARTITION_BLOCK_SIZE;
+            }
+            if (rightNumber == 0)
+            {
+                rightEnd -= PARTITION_BLOCK_SIZE;
+            }
+        }
+
+        //         ,    
+        while (true)
+        {
+            while (leftIterator < rightEnd && less(arrayElements[leftIterator], pivot))
+            {
+                leftIterator += 1;
+            }
+            while (leftIterator < rightEnd && less(pivot, arrayElements[rightEnd - 1]))
+            {
+                rightEnd -= 1;
+            }
+            if (leftIterator >= rightEnd)
+            {
+                break;
+            }
+            std::swap(arrayElements[leftIterator], arrayElements[rightEnd - 1]);
+            leftIterator += 1;
+            rightEnd -= 1;
+        }
+        std::swap(arrayElements[leftIterator], arrayElements[high]);
+        return leftIterator;
+    }
+
+
+
+    template <typename T, typename Less>
+    std::pair<size_t, size_t> QuickSort::partitionThreeWay(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+    {
+        /*
+         *        ,   .
+         *   ,  ,   - ,   .
+         *      .    .
+         *  lessEnd       ,
+         *  equalEnd -    ,   .
+         *  j     .        .
+         *  .  ,    j.    ,   j.
+         *    ,   a[equalEnd]  a[j] ,  equalEnd  j.
+         *    ,    a[lessEnd], a[equalEnd]  a[j],    .
+         *        ,     equalEnd.
+         */
+
+        auto lessEnd = low;
+        auto equalEnd = low;
+        for (auto rightIterator = low; rightIterator < high; ++rightIterator)
+        {
+            if (less(arrayElements[high], arrayElements[rightIterator]))
+            {
+                continue;
+            }
+            std::swap(arrayElements[equalEnd], arrayElements[rightIterator]);
+            if (less(arrayElements[equalEnd], arrayElements[high]))
+            {
+                std::swap(arrayElements[lessEnd], arrayElements[equalEnd]);
+                lessEnd += 1;
+            }
+            equalEnd += 1;
+        }
+        std::swap(arrayElements[equalEnd], arrayElements[high]);
+        return { lessEnd, equalEnd };
+    }
+
+
+
+    template <typename T, typename Less>
+    void QuickSort::selectMainElement(std::vector<T>& arrayElements, size_t low, size_t high, const Less& less)
+    {
+        auto mid = (low + high) / 2;
+        if (less(arrayElements[mid], arrayElements[low]))
+        {
+            std::swap(arrayElements[mid], arrayElements[low]);
+        }
+        if (less(arrayElements[high], arrayElements[low]))
+        {
+            std::swap(arrayElements[high], arrayElements[low]);
+        }
+        if (less(arrayElements[mid], arrayElements[high]))
+        {
+            std::swap(arrayElements[mid], arrayElements[high]);
+        }
+    }
+}
+
+
+
+/**
+ * \brief      ,         ( ),    std::less<uint32_t>.
+ */
+struct BlockPartitionLess
+{
+	std::function<bool(const uint32_t&, const uint32_t&)> less;
+
+	bool operator()(const uint32_t& lhs, const uint32_t& rhs) const { return less(lhs, rhs); }
+};
+
+namespace custom_algorithms
+{
+	template<>
+	struct IsBlockPartitionApplicable<uint32_t, BlockPartitionLess> : std::true_type {};
+}
+
+
+/**
+ * \brief   ,          ( . . ).
+ * \brief       ,  ""   :
+ * \brief        ,    ,     .
+ * \brief    BlockPartitionLess,        calculateStatistic,
+ * \brief    std::less<uint32_t>.
+ * \param n  .
+ * \param k   .
+ * \return ,   calculateStatistic(array, k)   .
+ */
+std::vector<uint32_t> generateAdversarialInput(const size_t n, const size_t k)
+{
+	const auto gas = static_cast<uint32_t>(n);
+	std::vector<uint32_t> values(n, gas);
+	uint32_t frozenNumber = 0;
+	uint32_t candidate = 0;
+	std::vector<uint32_t> indexes(n);
+	for (uint32_t i = 0; i < n; ++i)
+	{
+		indexes[i] = i;
+	}
+	custom_algorithms::QuickSort::calculateStatistic(indexes, k, BlockPartitionLess{ [&values, &frozenNumber, &candidate, gas](const uint32_t& lhs, const uint32_t& rhs)
+	{
+		if (values[lhs] == gas && values[rhs] == gas)
+		{
+			values[lhs == candidate ? lhs : rhs] = frozenNumber++;
+		}
+		if (values[lhs] == gas)
+		{
+			candidate = lhs;
+		}
+		else if (values[rhs] == gas)
+		{
+			candidate = rhs;
+		}
+		return values[lhs] < values[rhs];
+	} });
+	return values;
+}
+
+
+void QuickSortTest_matchesSortedArray()
+{
+	std::mt19937 generator(7);
+	for (auto test = 0; test < 300; ++test)
+	{
+		//       -
+		std::vector<uint32_t> numbers(1 + generator() % (test % 5 == 0 ? 200000 : 2000));
+		for (auto& number : numbers)
+		{
+			number = generator() % (test + 2);
+		}
+		if (test % 3 == 1)
+		{
+			std::sort(numbers.begin(), numbers.end());
+		}
+		auto sorted = numbers;
+		std::sort(sorted.begin(), sorted.end());
+		const auto k = test % 7 == 0 ? (test % 2) * (numbers.size() - 1) : generator() % numbers.size();
+		//     std::less,        
+		auto copy = numbers;
+		const std::function<bool(const uint32_t&, const uint32_t&)> less = std::less<uint32_t>();
+		assert(custom_algorithms::QuickSort::calculateStatistic(copy, k, less) == sorted[k]);
+		assert(custom_algorithms::QuickSort::calculateStatistic(numbers, k) == sorted[k]);
+	}
+	const auto adversarial = generateAdversarialInput(5000, 2500);
+	auto numbers = adversarial;
+	auto sorted = adversarial;
+	std::sort(sorted.begin(), sorted.end());
+	assert(custom_algorithms::QuickSort::calculateStatistic(numbers, 2500) == sorted[2500]);
+}
+
+
+void QuickSortTest_linearComparisonsOnAdversarialInput()
+{
+	//Introselect    ,    ,       
+	const size_t maxComparisonsPerElement = 16;
+	for (size_t n : { 5000, 100000 })
+	{
+		for (auto k : { n / 2, n / 10, n - 1 })
+		{
+			std::vector<uint32_t> organPipe(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				organPipe[i] = static_cast<uint32_t>(std::min(i, n - 1 - i));
+			}
+			for (auto numbers : { generateAdversarialInput(n, k), organPipe })
+			{
+				auto sorted = numbers;
+				std::sort(sorted.begin(), sorted.end());
+				size_t comparisons = 0;
+				const BlockPartitionLess countingLess{ [&comparisons](const uint32_t& lhs, const uint32_t& rhs)
+				{
+					comparisons += 1;
+					return lhs < rhs;
+				} };
+				assert(custom_algorithms::QuickSort::calculateStatistic(numbers, k, countingLess) == sorted[k]);
+				assert(comparisons <= maxComparisonsPerElement * n);
+			}
+		}
+	}
+}
+
+
+void QuickSortTest_multipleStatistics()
+{
+	std::mt19937 generator(11);
+	for (auto test = 0; test < 300; ++test)
+	{
+		std::vector<uint32_t> numbers(1 + generator() % (test % 5 == 0 ? 100000 : 3000));
+		for (auto& number : numbers)
+		{
+			number = generator() % (test + 2);
+		}
+		std::vector<size_t> ks(generator() % 20);
+		for (auto& k : ks)
+		{
+			k = generator() % numbers.size();
+		}
+		if (test % 4 == 0)
+		{
+			ks.push_back(0);
+			ks.push_back(numbers.size() - 1);
+		}
+		std::sort(ks.begin(), ks.end());
+		auto sorted = numbers;
+		std::sort(sorted.begin(), sorted.end());
+		const auto statistics = custom_algorithms::QuickSort::calculateStatistics(numbers, ks);
+		assert(statistics.size() == ks.size());
+		for (size_t i = 0; i < ks.size(); ++i)
+		{
+			assert(statistics[i] == sorted[ks[i]]);
+		}
+	}
+}
+
+
+void QuickSortTest_parallelMatchesSerial()
+{
+	std::mt19937 generator(13);
+	for (auto test = 0; test < 6; ++test)
+	{
+		std::vector<uint32_t> numbers(3000000 + generator() % 1000000);
+		for (auto& number : numbers)
+		{
+			number = generator() % (test % 2 == 0 ? 1000000001 : 3 * test + 1);
+		}
+		if (test == 4)
+		{
+			std::sort(numbers.begin(), numbers.end());
+		}
+		for (const auto k : { size_t{ 0 }, numbers.size() / 3, numbers.size() - 1, generator() % numbers.size() })
+		{
+			auto serial = numbers;
+			const auto expected = custom_algorithms::QuickSort::calculateStatistic(serial, k);
+			//        
+			std::vector<uint32_t> firstResult;
+			for (size_t threadsNumber : { 1, 2, 3, 8 })
+			{
+				auto parallel = numbers;
+				assert(custom_algorithms::QuickSort::calculateStatisticParallel(parallel, k, threadsNumber) == expected);
+				if (threadsNumber == 1)
+				{
+					continue;
+				}
+				if (firstResult.empty())
+				{
+					firstResult = parallel;
+				}
+				assert(parallel == firstResult);
+			}
+		}
+	}
+}
+
+
+/**
+ * \brief         T.
+ * \param generator   .
+ * \param size  .
+ * \param modulo      (0 -   ).
+ */
+template<typename T>
+void checkRadixSelection(std::mt19937_64& generator, const size_t size, const uint64_t modulo)
+{
+	std::vector<T> numbers(size);
+	for (auto& number : numbers)
+	{
+		number = static_cast<T>(modulo == 0 ? generator() : generator() % modulo);
+	}
+	const auto original = numbers;
+	auto sorted = numbers;
+	std::sort(sorted.begin(), sorted.end());
+	for (const auto k : { size_t{ 0 }, size - 1, static_cast<size_t>(generator() % size) })
+	{
+		assert(custom_algorithms::QuickSort::calculateStatisticRadix(numbers, k) == sorted[k]);
+	}
+	assert(numbers == original);
+}
+
+
+void QuickSortTest_radixMatchesSorted()
+{
+	std::mt19937_64 generator(17);
+	for (auto test = 0; test < 200; ++test)
+	{
+		const size_t size = 1 + generator() % (test % 10 == 0 ? 300000 : 5000);
+		const uint64_t modulo = test % 3 == 0 ? 0 : 1 + generator() % 100;
+		checkRadixSelection<uint32_t>(generator, size, modulo);
+		checkRadixSelection<int32_t>(generator, size, modulo);
+		checkRadixSelection<int64_t>(generator, size, modulo);
+		checkRadixSelection<uint16_t>(generator, size, modulo);
+		checkRadixSelection<int8_t>(generator, size, modulo);
+	}
+}
+
+
+void QuickSortTest_constSelectionKeepsArray()
+{
+	std::mt19937 generator(23);
+	for (auto test = 0; test < 200; ++test)
+	{
+		std::vector<uint32_t> numbers(1 + generator() % (test % 4 == 0 ? 300000 : 20000));
+		for (auto& number : numbers)
+		{
+			number = generator() % (test % 3 == 0 ? 1000000001 : test + 1);
+		}
+		if (test % 5 == 2)
+		{
+			std::sort(numbers.begin(), numbers.end());
+		}
+		const auto original = numbers;
+		auto sorted = numbers;
+		std::sort(sorted.begin(), sorted.end());
+		for (const auto k : { size_t{ 0 }, numbers.size() - 1, numbers.size() / 2, generator() % numbers.size() })
+		{
+			assert(custom_algorithms::QuickSort::calculateStatisticConst(numbers, k) == sorted[k]);
+			assert(custom_algorithms::QuickSort::calculateStatisticConst(numbers, k, std::greater<uint32_t>()) == sorted[numbers.size() - 1 - k]);
+		}
+		assert(numbers == original);
+	}
+}
+
+
+void QuickSortTest_partialSortMatchesSort()
+{
+	std::mt19937 generator(29);
+	for (auto test = 0; test < 300; ++test)
+	{
+		std::vector<uint32_t> numbers(generator() % (test % 10 == 0 ? 400000 : 3000));
+		for (auto& number : numbers)
+		{
+			number = generator() % (test % 3 == 0 ? 1000000001 : test + 1);
+		}
+		auto sorted = numbers;
+		std::sort(sorted.begin(), sorted.end());
+		// k    ,  -    
+		const auto k = test % 4 == 0 ? generator() % 100 : (test % 4 == 1 ? numbers.size() + generator() % 3 : generator() % (numbers.size() + 1));
+		const auto prefixSize = std::min(k, numbers.size());
+
+		const auto largest = custom_algorithms::QuickSort::topK(numbers, k, std::greater<uint32_t>());
+		assert(largest.size() == prefixSize);
+		assert(std::equal(largest.begin(), largest.end(), sorted.rbegin()));
+		const auto smallest = custom_algorithms::QuickSort::topK(numbers, k);
+		assert(std::equal(smallest.begin(), smallest.end(), sorted.begin()) && smallest.size() == prefixSize);
+
+		custom_algorithms::QuickSort::partialSort(numbers, k);
+		assert(std::equal(numbers.begin(), numbers.begin() + prefixSize, sorted.begin()));
+		std::sort(numbers.begin(), numbers.end());
+		assert(numbers == sorted);
+	}
+}
+
+
+void QuantileSketchTest_matchesExactStatistic()
+{
+	const size_t n = 1000000;
+	const auto epsilon = 0.01;
+	std::mt19937 generator(19);
+	for (auto test = 0; test < 6; ++test)
+	{
+		std::vector<uint32_t> numbers(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			numbers[i] = test % 3 == 0 ? generator() % 1000000001 : (test % 3 == 1 ? generator() % 100 : static_cast<uint32_t>(i));
+		}
+		//  -    
+		custom_containers::QuantileSketch<uint32_t> sketch(epsilon, test);
+		custom_containers::QuantileSketch<uint32_t> secondSketch(epsilon, test + 100);
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (test % 2 == 1 && i % 3 == 0)
+			{
+				secondSketch.insert(numbers[i]);
+			}
+			else
+			{
+				sketch.insert(numbers[i]);
+			}
+		}
+		sketch.merge(secondSketch);
+		assert(sketch.size() == n);
+		assert(sketch.retainedNumber() < n / 100);
+		for (auto q : { 0.0, 0.01, 0.1, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0 })
+		{
+			const auto estimate = sketch.quantile(q);
+			//       (q - epsilon) * n  (q + epsilon) * n
+			const auto lowRank = static_cast<size_t>(std::max(0.0, q - epsilon) * (n - 1));
+			const auto highRank = static_cast<size_t>(std::min(1.0, q + epsilon) * (n - 1));
+			assert(custom_algorithms::QuickSort::calculateStatistic(numbers, lowRank) <= estimate);
+			assert(estimate <= custom_algorithms::QuickSort::calculateStatistic(numbers, highRank));
+		}
+	}
+	//          
+	custom_containers::QuantileSketch<uint32_t> doubled(epsilon, 5);
+	custom_containers::QuantileSketch<uint32_t> copy(epsilon, 5);
+	custom_containers::QuantileSketch<uint32_t> reference(epsilon, 5);
+	for (uint32_t i = 0; i < 100000; ++i)
+	{
+		doubled.insert(i * 7919 % 100000);
+		copy.insert(i * 7919 % 100000);
+		reference.insert(i * 7919 % 100000);
+	}
+	doubled.merge(doubled);
+	reference.merge(copy);
+	assert(doubled.size() == 200000 && doubled.retainedNumber() == reference.retainedNumber());
+	for (auto q : { 0.0, 0.1, 0.5, 0.9, 1.0 })
+	{
+		assert(doubled.quantile(q) == reference.quantile(q));
+	}
+}
+
+
+/**
+ * \brief        .  ,    .
+ * \return    .
+ */
+double measureSelection(const std::vector<uint32_t>& numbers, const std::function<void(std::vector<uint32_t>&)>& select)
+{
+	auto array = numbers;
+	const auto start = std::chrono::steady_clock::now();
+	select(array);
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+
+void QuickSortBenchmark_largeArrays()
+{
+	std::mt19937 generator(42);
+	for (size_t n : { 1000, 10000, 100000, 1000000, 10000000 })
+	{
+		std::vector<uint32_t> numbers(n);
+		for (auto& number : numbers)
+		{
+			number = generator() % 1000000001;
+		}
+		size_t comparisons = 0;
+		const std::function<bool(const uint32_t&, const uint32_t&)> countingLess = [&comparisons](const uint32_t& lhs, const uint32_t& rhs)
+		{
+			comparisons += 1;
+			return lhs < rhs;
+		};
+		const auto k = n / 3;
+		const auto time = measureSelection(numbers, [k, &countingLess](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, k, countingLess); });
+		std::cout << "n = " << n << ", k = n / 3: " << time << " ms, "
+			<< static_cast<double>(comparisons) / n << " comparisons per element" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_blockPartition()
+{
+	std::mt19937 generator(42);
+	const std::function<bool(const uint32_t&, const uint32_t&)> less = std::less<uint32_t>();
+	for (size_t n : { 1000, 100000, 10000000 })
+	{
+		const size_t repeats = 100000000 / n;
+		std::vector<uint32_t> numbers(n);
+		double functionTime = 0;
+		double blockTime = 0;
+		for (size_t repeat = 0; repeat < repeats; ++repeat)
+		{
+			for (auto& number : numbers)
+			{
+				number = generator() % 1000000001;
+			}
+			const auto k = generator() % n;
+			functionTime += measureSelection(numbers, [k, &less](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, k, less); });
+			blockTime += measureSelection(numbers, [k](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, k); });
+		}
+		std::cout << "n = " << n << ": std::function " << functionTime / repeats << " ms, block partition " << blockTime / repeats << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_parallel()
+{
+	const size_t n = 100000000;
+	std::mt19937 generator(42);
+	std::vector<uint32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = generator() % 1000000001;
+	}
+	std::cout << "n = " << n << ", serial: "
+		<< measureSelection(numbers, [n](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, n / 2); }) << " ms" << std::endl;
+	for (size_t threadsNumber : { 1, 2, 4, 8, 16 })
+	{
+		std::cout << "n = " << n << ", " << threadsNumber << " threads: "
+			<< measureSelection(numbers, [n, threadsNumber](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatisticParallel(array, n / 2, threadsNumber); }) << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_radixSelect()
+{
+	std::mt19937 generator(42);
+	//10^9  uint32_t  4 ,  measureSelection    ,   
+	//        10 
+	for (size_t n : { 1000000, 10000000, 100000000 })
+	{
+		std::vector<uint32_t> numbers(n);
+		for (auto& number : numbers)
+		{
+			number = generator() % 1000000001;
+		}
+		std::cout << "n = " << n
+			<< ": quickselect " << measureSelection(numbers, [n](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, n / 2); }) << " ms"
+			<< ", radix select " << measureSelection(numbers, [n](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatisticRadix(array, n / 2); }) << " ms" << std::endl;
+	}
+}
+
+
+void OrderStatisticTreeTest_matchesSortedArray()
+{
+	std::mt19937 generator(23);
+	for (auto test = 0; test < 3; ++test)
+	{
+		custom_containers::OrderStatisticTree<uint32_t> tree;
+		std::vector<uint32_t> numbers;
+		for (size_t i = 0; i < 3000; ++i)
+		{
+			const auto number = test == 0 ? generator() % 1000000001 : (test == 1 ? generator() % 10 : static_cast<uint32_t>(i));
+			tree.insert(number);
+			numbers.push_back(number);
+			assert(tree.size() == numbers.size());
+			//    ,     -  
+			auto sorted = numbers;
+			std::sort(sorted.begin(), sorted.end());
+			assert(tree.median() == sorted[(sorted.size() - 1) / 2]);
+			if (i % 100 == 0)
+			{
+				for (size_t k = 0; k < sorted.size(); ++k)
+				{
+					assert(tree.kth(k) == sorted[k]);
+				}
+			}
+		}
+	}
+	// ,       
+	for (auto test = 0; test < 3; ++test)
+	{
+		custom_containers::OrderStatisticTree<uint32_t> tree;
+		std::vector<uint32_t> numbers(300000);
+		for (size_t i = 0; i < numbers.size(); ++i)
+		{
+			numbers[i] = test == 0 ? generator() % 1000000001 : (test == 1 ? generator() % 10 : static_cast<uint32_t>(numbers.size() - i));
+			tree.insert(numbers[i]);
+		}
+		std::sort(numbers.begin(), numbers.end());
+		for (size_t k = 0; k < numbers.size(); ++k)
+		{
+			assert(tree.kth(k) == numbers[k]);
+		}
+	}
+	//  
+	custom_containers::OrderStatisticTree<int> descendingTree{ std::greater<int>() };
+	for (auto number : { 5, 1, 4, 2, 3 })
+	{
+		descendingTree.insert(number);
+	}
+	assert(descendingTree.kth(0) == 5 && descendingTree.median() == 3 && descendingTree.kth(4) == 1);
+}
+
+
+void QuantileSketchBenchmark_ingest()
+{
+	const size_t n = 100000000;
+	std::mt19937 generator(42);
+	for (auto epsilon : { 0.01, 0.001 })
+	{
+		custom_containers::QuantileSketch<uint32_t> sketch(epsilon);
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < n; ++i)
+		{
+			sketch.insert(generator() % 1000000001);
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "epsilon = " << epsilon << ": " << n / elapsed.count() / 1e6 << " million inserts per second, "
+			<< sketch.retainedNumber() << " elements retained, median " << sketch.quantile(0.5) << std::endl;
+	}
+}
+
+
+void OrderStatisticTreeBenchmark_streamingMedian()
+{
+	const size_t n = 1000000;
+	std::mt19937 generator(42);
+	std::vector<uint32_t> stream(n);
+	for (auto& number : stream)
+	{
+		number = generator() % 1000000001;
+	}
+	for (size_t batchSize : { 100, 1000, 10000 })
+	{
+		//     
+		uint64_t checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::vector<uint32_t> numbers;
+		for (size_t i = 0; i < n; i += batchSize)
+		{
+			numbers.insert(numbers.end(), stream.begin() + i, stream.begin() + std::min(n, i + batchSize));
+			checksum += custom_algorithms::QuickSort::calculateStatistic(numbers, (numbers.size() - 1) / 2);
+		}
+		const std::chrono::duration<double, std::milli> selectionTime = std::chrono::steady_clock::now() - start;
+
+		start = std::chrono::steady_clock::now();
+		custom_containers::OrderStatisticTree<uint32_t> tree;
+		for (size_t i = 0; i < n; i += batchSize)
+		{
+			for (auto j = i; j < std::min(n, i + batchSize); ++j)
+			{
+				tree.insert(stream[j]);
+			}
+			checksum -= tree.median();
+		}
+		const std::chrono::duration<double, std::milli> treeTime = std::chrono::steady_clock::now() - start;
+		assert(checksum == 0);
+		std::cout << "n = " << n << ", batch = " << batchSize << ": repeated calculateStatistic " << selectionTime.count()
+			<< " ms, order statistic tree " << treeTime.count() << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_constSelection()
+{
+	std::mt19937 generator(42);
+	for (size_t n : { 1000000, 10000000, 100000000 })
+	{
+		std::vector<uint32_t> numbers(n);
+		for (auto& number : numbers)
+		{
+			number = generator() % 1000000001;
+		}
+		//  :  ,   ,      
+		auto start = std::chrono::steady_clock::now();
+		auto copy = numbers;
+		custom_algorithms::QuickSort::calculateStatistic(copy, n / 2);
+		const std::chrono::duration<double, std::milli> copyTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		custom_algorithms::QuickSort::calculateStatisticConst(numbers, n / 2);
+		const std::chrono::duration<double, std::milli> constTime = std::chrono::steady_clock::now() - start;
+		std::cout << "n = " << n << ": copy and select " << copyTime.count() << " ms, const selection " << constTime.count() << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_partialSort()
+{
+	const size_t n = 10000000;
+	std::mt19937 generator(42);
+	std::vector<uint32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = generator() % 1000000001;
+	}
+	for (size_t k : { 10, 1000, 100000, 1000000 })
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const auto smallest = custom_algorithms::QuickSort::topK(numbers, k);
+		const std::chrono::duration<double, std::milli> topKTime = std::chrono::steady_clock::now() - start;
+		std::cout << "n = " << n << ", k = " << k
+			<< ": partialSort " << measureSelection(numbers, [k](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::partialSort(array, k); }) << " ms"
+			<< ", topK " << topKTime.count() << " ms"
+			<< ", std::partial_sort " << measureSelection(numbers, [k](std::vector<uint32_t>& array) { std::partial_sort(array.begin(), array.begin() + k, array.end()); }) << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_quantiles()
+{
+	const size_t n = 10000000;
+	std::mt19937 generator(42);
+	std::vector<uint32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = generator() % 1000000001;
+	}
+	//p50, p90, p99, p999   
+	std::vector<size_t> percentiles;
+	for (size_t percent = 1; percent < 100; ++percent)
+	{
+		percentiles.push_back(n / 100 * percent);
+	}
+	for (const auto& ks : { std::vector<size_t>{ n / 2, n / 10 * 9, n / 100 * 99, n / 1000 * 999 }, percentiles })
+	{
+		const auto separateTime = measureSelection(numbers, [&ks](std::vector<uint32_t>& array)
+		{
+			for (const auto k : ks)
+			{
+				custom_algorithms::QuickSort::calculateStatistic(array, k);
+			}
+		});
+		const auto jointTime = measureSelection(numbers, [&ks](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistics(array, ks); });
+		std::cout << "n = " << n << ", " << ks.size() << " quantiles: separate calls " << separateTime << " ms, one call " << jointTime << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_duplicateKeys()
+{
+	const size_t n = 10000000;
+	std::mt19937 generator(42);
+	for (uint32_t distinctValues : { 2, 16, 1000 })
+	{
+		std::vector<uint32_t> numbers(n);
+		for (auto& number : numbers)
+		{
+			number = generator() % distinctValues;
+		}
+		std::cout << "n = " << n << ", " << distinctValues << " distinct values: "
+			<< measureSelection(numbers, [n](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, n / 2); }) << " ms" << std::endl;
+	}
+}
+
+
+void QuickSortBenchmark_adversarialInputs()
+{
+	std::mt19937 generator(42);
+	for (size_t n : { 10000, 100000, 1000000 })
+	{
+		const auto k = n / 2;
+		std::vector<uint32_t> randomNumbers(n);
+		for (auto& number : randomNumbers)
+		{
+			number = generator() % 1000000001;
+		}
+		std::vector<uint32_t> organPipe(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			organPipe[i] = static_cast<uint32_t>(std::min(i, n - 1 - i));
+		}
+		const auto adversarial = generateAdversarialInput(n, k);
+		const auto select = [k](std::vector<uint32_t>& array) { custom_algorithms::QuickSort::calculateStatistic(array, k); };
+		std::cout << "n = " << n
+			<< ": random " << measureSelection(randomNumbers, select) << " ms"
+			<< ", organ pipe " << measureSelection(organPipe, select) << " ms"
+			<< ", adversarial " << measureSelection(adversarial, select) << " ms" << std::endl;
+	}
+}
+
+
+int main()
+{
+	const auto is_test = false;
+	if (is_test)
+	{
+		QuickSortTest_matchesSortedArray();
+		QuickSortTest_linearComparisonsOnAdversarialInput();
+		QuickSortTest_multipleStatistics();
+		QuickSortTest_parallelMatchesSerial();
+		QuickSortTest_radixMatchesSorted();
+		QuickSortTest_constSelectionKeepsArray();
+		QuickSortTest_partialSortMatchesSort();
+		QuantileSketchTest_matchesExactStatistic();
+		OrderStatisticTreeTest_matchesSortedArray();
+		return 0;
+	}
+	const auto is_benchmark = false;
+	if (is_benchmark)
+	{
+		QuickSortBenchmark_adversarialInputs();
+		QuickSortBenchmark_duplicateKeys();
+		QuickSortBenchmark_largeArrays();
+		QuickSortBenchmark_quantiles();
+		QuickSortBenchmark_blockPartition();
+		QuickSortBenchmark_parallel();
+		QuickSortBenchmark_radixSelect();
+		QuickSortBenchmark_constSelection();
+		QuickSortBenchmark_partialSort();
+		QuantileSketchBenchmark_ingest();
+		OrderStatisticTreeBenchmark_streamingMedian();
+		return 0;
+	}
+
 	std::ifstream in;
 	try
 	{
@@ -0,0 +1,926 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <thread>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_algorithms
+{
+	/**
+	 * \brief Класс, объединяющий алгоритмы сортировки массива и функцию, выбирающую подходящий из них.
+	 * \brief Функции сортировки принимают функцию сравнения как параметр шаблона, чтобы сравнение встраивалось.
+	 */
+	class Sorting
+	{
+	public:
+		/**
+		 * \brief Сортировка массива с автоматическим выбором алгоритма.
+		 * \brief Короткий массив сортируется вставками. Массив из небольшого числа монотонных серий (в том числе отсортированный
+		 * \brief и развёрнутый) распознаётся за один проход и сортируется естественным слиянием.
+		 * \brief Большой массив при наличии нескольких ядер сортируется параллельной сортировкой выборкой.
+		 * \brief Иначе целые числа сортируются поразрядной сортировкой, остальные типы - интроспективной. Если по выборке соседних пар
+		 * \brief видно, что массив почти упорядочен, целые числа тоже сортируются интроспективной сортировкой: поразрядная не использует
+		 * \brief имеющийся порядок, а разбиения почти упорядоченного массива хорошо предсказываются процессором.
+		 * \tparam T Тип элементов в массиве. Должен иметь конструктор по умолчанию.
+		 * \tparam Less Тип функции сравнения.
+		 * \param arrayElements Массив элементов.
+		 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static void sort(std::vector<T>& arrayElements, const Less& less = Less());
+
+		/**
+		 * \brief Поразрядная сортировка (LSD) массива целых чисел.
+		 * \brief Количества всех разрядов подсчитываются за один проход, разряды, одинаковые у всех чисел, пропускаются.
+		 * \brief У знаковых чисел инвертируется старший бит, чтобы отрицательные числа оказались перед положительными.
+		 * \brief Время работы: O(n * sizeof(T)), дополнительная память: O(n).
+		 * \tparam T Целочисленный тип элементов в массиве.
+		 * \param arrayElements Массив элементов.
+		 */
+		template<typename T>
+		static void radixSort(std::vector<T>& arrayElements);
+
+		/**
+		 * \brief Интроспективная сортировка: быстрая сортировка без рекурсии с опорным элементом "медиана трёх" (для больших
+		 * \brief отрезков - "медиана медиан трёх"), сортировкой вставками коротких отрезков и переходом к пирамидальной
+		 * \brief сортировке при слишком большой глубине разбиений. Для арифметических типов со сравнением std::less
+		 * \brief используется блочное разбиение без ветвлений.
+		 * \brief Время работы в худшем случае: O(n log n), дополнительная память: O(log n).
+		 * \tparam T Тип элементов в массиве.
+		 * \tparam Less Тип функции сравнения.
+		 * \param arrayElements Массив элементов.
+		 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static void introSort(std::vector<T>& arrayElements, const Less& less = Less());
+
+		/**
+		 * \brief Естественная сортировка слиянием: массив разбивается на неубывающие и строго убывающие серии, убывающие
+		 * \brief серии разворачиваются, после чего соседние серии сливаются попарно с галопом (mergeAdjacent). Сортировка устойчива.
+		 * \brief Время работы: O(n log r), где r - количество серий, дополнительная память: O(n).
+		 * \tparam T Тип элементов в массиве.
+		 * \tparam Less Тип функции сравнения.
+		 * \param arrayElements Массив элементов.
+		 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static void naturalMergeSort(std::vector<T>& arrayElements, const Less& less = Less());
+
+		/**
+		 * \brief Параллельная сортировка выборкой (sample sort).
+		 * \brief По отсортированной выборке выбираются разделители корзин, по одной корзине на поток. Потоки параллельно
+		 * \brief подсчитывают, сколько элементов их части массива попадает в каждую корзину, по префиксным суммам элементы
+		 * \brief раскладываются по корзинам, после чего каждый поток сортирует свою корзину. Элементы, равные разделителю,
+		 * \brief собираются в отдельную корзину, которая не сортируется, поэтому частый ключ не попадает целиком к одному потоку.
+		 * \brief Дополнительная память: O(n).
+		 * \tparam T Тип элементов в массиве.
+		 * \tparam Less Тип функции сравнения.
+		 * \param arrayElements Массив элементов.
+		 * \param threadsNumber Количество потоков.
+		 * \param less Функция сравнения элементов массива. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		template<typename T, typename Less = std::less<T>>
+		static void parallelSampleSort(std::vector<T>& arrayElements, const size_t threadsNumber, const Less& less = Less());
+
+	private:
+		/**
+		 * \brief Сортировка отрезка массива [low, high) в одном потоке: поразрядная, если она применима и отрезок не почти упорядочен,
+		 * \brief иначе интроспективная.
+		 */
+		template<typename T, typename Less>
+		static void sortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Поразрядная сортировка отрезка массива [low, high).
+		 */
+		template<typename T>
+		static void radixSortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high);
+
+		/**
+		 * \brief Интроспективная сортировка отрезка массива [low, high).
+		 */
+		template<typename T, typename Less>
+		static void introSortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Сортировка отрезка массива [low, high) вставками.
+		 */
+		template<typename T, typename Less>
+		static void insertionSort(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Распознаёт массив из небольшого числа монотонных серий и сортирует его естественным слиянием.
+		 * \brief Подсчёт серий прерывается, как только их становится больше n / PRESORTED_RUNS_RATIO.
+		 * \return True, если массив отсортирован, иначе - false.
+		 */
+		template<typename T, typename Less>
+		static bool sortPresorted(std::vector<T>& arrayElements, const Less& less);
+
+		/**
+		 * \brief Оценка беспорядка отрезка [low, high) по выборке: у DISORDER_SAMPLE_SIZE равномерно расположенных пар соседних
+		 * \brief элементов подсчитываются спуски (следующий элемент меньше предыдущего). У случайного массива спуск - примерно
+		 * \brief в половине пар, у почти упорядоченного - в малой доле.
+		 * \return True, если спусков меньше доли 1 / NEARLY_SORTED_DESCENTS_RATIO выборки.
+		 */
+		template<typename T, typename Less>
+		static bool isNearlySorted(const std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Поиск конца серии, начинающейся с runBegin: неубывающей или убывающей.
+		 * \param isStrict Если true, то убывающая серия должна убывать строго, и её разворот не меняет порядок равных элементов.
+		 * \return Пара: конец (за последним элементом) серии и признак того, что серия убывает.
+		 */
+		template<typename T, typename Less>
+		static std::pair<size_t, bool> findRun(const std::vector<T>& arrayElements, const size_t runBegin, const bool isStrict, const Less& less);
+
+		/**
+		 * \brief Выбор опорного элемента отрезка [low, high] и перемещение его на место high.
+		 * \brief Для коротких отрезков - медиана трёх, для длинных - медиана медиан трёх троек (ninther).
+		 */
+		template<typename T, typename Less>
+		static void selectMainElement(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Упорядочивает три элемента массива так, чтобы медиана оказалась на месте middle.
+		 */
+		template<typename T, typename Less>
+		static void sortThree(std::vector<T>& arrayElements, const size_t first, const size_t middle, const size_t last, const Less& less);
+
+		/**
+		 * \brief Разбиение отрезка [low, high] по опорному элементу, стоящему на месте high.
+		 * \brief Слева собираются элементы не больше опорного, справа - не меньше, опорный ставится между ними.
+		 * \return Итоговая позиция опорного элемента.
+		 */
+		template<typename T, typename Less>
+		static size_t partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Блочное разбиение без ветвлений (BlockQuicksort), аналогичное QuickSort::partitionBlock из задачи 4.
+		 * \return Итоговая позиция опорного элемента.
+		 */
+		template<typename T, typename Less>
+		static size_t partitionBlock(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less);
+
+		/**
+		 * \brief Разбиение методом Хоара нерассмотренной части [leftIterator, rightEnd) с постановкой опорного элемента с места high.
+		 * \return Итоговая позиция опорного элемента.
+		 */
+		template<typename T, typename Less>
+		static size_t partitionHoare(std::vector<T>& arrayElements, size_t leftIterator, size_t rightEnd, const size_t high, const Less& less);
+
+		/**
+		 * \brief Слияние соседних отсортированных отрезков [low, middle) и [middle, high) с галопом, как mergeRuns из задачи 3.
+		 * \brief Начало левого и конец правого отрезков, уже стоящие на своих местах, отбрасываются галопирующим поиском,
+		 * \brief оставшаяся часть левого отрезка переносится в буфер. Если один отрезок выигрывает MINIMAL_GALLOP сравнений подряд,
+		 * \brief его элементы, меньшие текущего элемента другого отрезка, переносятся одним блоком.
+		 */
+		template<typename T, typename Less>
+		static void mergeAdjacent(std::vector<T>& arrayElements, size_t low, const size_t middle, size_t high, std::vector<T>& buffer, const Less& less);
+
+		/**
+		 * \brief Экспоненциальный (галопирующий) поиск первого элемента, строго большего key. Аналог std::upper_bound,
+		 * \brief работающий за O(log d), где d - расстояние от first до ответа.
+		 */
+		template<typename RandomIt, typename T, typename Less>
+		static RandomIt gallopUpperBound(RandomIt first, RandomIt last, const T& key, const Less& less);
+
+		/**
+		 * \brief Экспоненциальный (галопирующий) поиск первого элемента, не меньшего key. Аналог std::lower_bound,
+		 * \brief работающий за O(log d), где d - расстояние от first до ответа.
+		 */
+		template<typename RandomIt, typename T, typename Less>
+		static RandomIt gallopLowerBound(RandomIt first, RandomIt last, const T& key, const Less& less);
+
+		/**
+		 * \brief Запускает function(thread) для thread от 0 до threadsNumber - 1 в отдельных потоках и дожидается их завершения.
+		 * \brief Нулевой вызов выполняется в вызывающем потоке.
+		 */
+		template<typename Function>
+		static void runInThreads(const size_t threadsNumber, const Function& function);
+
+		/**
+		 * \brief Применимо ли блочное разбиение: сравнение встраивается и не имеет побочных эффектов, поэтому его можно
+		 * \brief выполнять без ветвлений для всех элементов блока.
+		 */
+		template<typename T, typename Less>
+		static constexpr bool isBlockPartitionApplicable() { return std::is_arithmetic_v<T> && std::is_same_v<Less, std::less<T>>; }
+
+		/**
+		 * \brief Применима ли поразрядная сортировка: целочисленный тип и сравнение std::less.
+		 */
+		template<typename T, typename Less>
+		static constexpr bool isRadixSortApplicable() { return std::is_integral_v<T> && !std::is_same_v<T, bool> && std::is_same_v<Less, std::less<T>>; }
+
+		/**
+		 * \brief Отрезки не длиннее этого сортируются вставками.
+		 */
+		static constexpr size_t INSERTION_SORT_THRESHOLD = 16;
+		/**
+		 * \brief Начиная с этой длины отрезка опорный элемент выбирается как медиана медиан трёх троек.
+		 */
+		static constexpr size_t NINTHER_THRESHOLD = 128;
+		/**
+		 * \brief Размер блока в блочном разбиении. Смещения внутри блока хранятся в uint8_t.
+		 */
+		static constexpr size_t PARTITION_BLOCK_SIZE = 128;
+		/**
+		 * \brief Начиная с этой длины целые числа сортируются поразрядной сортировкой: на коротких массивах
+		 * \brief подсчёт количеств разрядов дороже интроспективной сортировки.
+		 */
+		static constexpr size_t RADIX_SORT_THRESHOLD = 1024;
+		/**
+		 * \brief Количество бит в разряде поразрядной сортировки: 32-битные числа сортируются за 3 прохода, 64-битные - за 6.
+		 */
+		static constexpr size_t RADIX_DIGIT_BITS = 11;
+		/**
+		 * \brief Массив, состоящий менее чем из n / PRESORTED_RUNS_RATIO монотонных серий (но не менее чем из двух), сортируется
+		 * \brief естественным слиянием. При большем числе серий слияние медленнее интроспективной сортировки почти упорядоченного массива:
+		 * \brief на 10^7 чисел с 2000 спусками они сравнимы, с 20000 слияние уже проигрывает.
+		 */
+		static constexpr size_t PRESORTED_RUNS_RATIO = 4096;
+		/**
+		 * \brief Количество пар соседних элементов в выборке, по которой оценивается беспорядок отрезка.
+		 */
+		static constexpr size_t DISORDER_SAMPLE_SIZE = 1024;
+		/**
+		 * \brief Отрезок считается почти упорядоченным, если спуском оказалась менее чем 1 / NEARLY_SORTED_DESCENTS_RATIO доля пар выборки.
+		 * \brief На 10^7 чисел интроспективная сортировка быстрее поразрядной ещё при четверти спусков (20% случайных обменов).
+		 */
+		static constexpr size_t NEARLY_SORTED_DESCENTS_RATIO = 4;
+		/**
+		 * \brief Количество подряд выигранных одним отрезком сравнений, после которого слияние переходит в режим галопа.
+		 */
+		static constexpr size_t MINIMAL_GALLOP = 7;
+		/**
+		 * \brief Начиная с этой длины массив сортируется в нескольких потоках.
+		 */
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 20;
+		/**
+		 * \brief Количество элементов выборки на одну корзину в параллельной сортировке.
+		 */
+		static constexpr size_t SAMPLE_OVERSAMPLING = 64;
+	};
+
+
+
+	template <typename T, typename Less>
+	void Sorting::sort(std::vector<T>& arrayElements, const Less& less)
+	{
+		const auto size = arrayElements.size();
+		if (size <= INSERTION_SORT_THRESHOLD)
+		{
+			insertionSort(arrayElements, 0, size, less);
+			return;
+		}
+		if (sortPresorted(arrayElements, less))
+		{
+			return;
+		}
+		const auto threadsNumber = static_cast<size_t>(std::thread::hardware_concurrency());
+		if (size >= PARALLEL_THRESHOLD && threadsNumber > 1)
+		{
+			parallelSampleSort(arrayElements, threadsNumber, less);
+			return;
+		}
+		sortSegment(arrayElements, 0, size, less);
+	}
+
+
+
+	template <typename T>
+	void Sorting::radixSort(std::vector<T>& arrayElements)
+	{
+		radixSortSegment(arrayElements, 0, arrayElements.size());
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::introSort(std::vector<T>& arrayElements, const Less& less)
+	{
+		introSortSegment(arrayElements, 0, arrayElements.size(), less);
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::naturalMergeSort(std::vector<T>& arrayElements, const Less& less)
+	{
+		const auto size = arrayElements.size();
+		std::vector<size_t> runsBorders{ 0 };
+		for (size_t runBegin = 0; runBegin < size;)
+		{
+			const auto run = findRun(arrayElements, runBegin, true, less);
+			//Строго убывающая серия после разворота становится возрастающей, равных элементов в ней нет, поэтому устойчивость сохраняется
+			if (run.second)
+			{
+				std::reverse(arrayElements.begin() + runBegin, arrayElements.begin() + run.first);
+			}
+			runBegin = run.first;
+			runsBorders.push_back(runBegin);
+		}
+		if (size == 0)
+		{
+			runsBorders.push_back(0);
+		}
+
+		//Сливаем серии попарно, пока не останется одна
+		std::vector<T> buffer;
+		while (runsBorders.size() > 2)
+		{
+			size_t mergedNumber = 0;
+			size_t run = 0;
+			for (; run + 2 < runsBorders.size(); run += 2)
+			{
+				mergeAdjacent(arrayElements, runsBorders[run], runsBorders[run + 1], runsBorders[run + 2], buffer, less);
+				runsBorders[mergedNumber++] = runsBorders[run];
+			}
+			//Непарная последняя серия переходит на следующий уровень без изменений
+			if (run + 1 < runsBorders.size())
+			{
+				runsBorders[mergedNumber++] = runsBorders[run];
+			}
+			runsBorders[mergedNumber++] = size;
+			runsBorders.resize(mergedNumber);
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::parallelSampleSort(std::vector<T>& arrayElements, const size_t threadsNumber, const Less& less)
+	{
+		assert(threadsNumber > 0);
+		const auto size = arrayElements.size();
+		if (threadsNumber == 1 || size < threadsNumber * SAMPLE_OVERSAMPLING)
+		{
+			sortSegment(arrayElements, 0, size, less);
+			return;
+		}
+
+		//Выборка берётся с фиксированным шагом, чтобы результат не зависел от запуска
+		const auto sampleSize = threadsNumber * SAMPLE_OVERSAMPLING;
+		std::vector<T> sample;
+		sample.reserve(sampleSize);
+		for (size_t i = 0; i < sampleSize; ++i)
+		{
+			sample.push_back(arrayElements[i * (size / sampleSize)]);
+		}
+		sortSegment(sample, 0, sampleSize, less);
+		//Равные соседние разделители означают, что ключ занимает в выборке больше корзины: оставляем один разделитель,
+		//а равные ему элементы получают свою корзину, которую не нужно сортировать (как в IPS4o)
+		std::vector<T> splitters;
+		for (size_t thread = 1; thread < threadsNumber; ++thread)
+		{
+			const auto& candidate = sample[thread * SAMPLE_OVERSAMPLING];
+			if (splitters.empty() || less(splitters.back(), candidate))
+			{
+				splitters.push_back(candidate);
+			}
+		}
+		sample.clear();
+		sample.shrink_to_fit();
+		//Корзина 2i - элементы между разделителями i - 1 и i, корзина 2i + 1 - элементы, равные разделителю i
+		const auto bucketsNumber = 2 * splitters.size() + 1;
+		const auto findBucket = [&splitters, &less](const T& value)
+		{
+			const auto upper = static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), value, less) - splitters.begin());
+			return upper != 0 && !less(splitters[upper - 1], value) ? 2 * upper - 1 : 2 * upper;
+		};
+
+		//counts[thread * bucketsNumber + bucket] - сколько элементов части потока thread попадает в корзину bucket
+		std::vector<size_t> counts(threadsNumber * bucketsNumber, 0);
+		runInThreads(threadsNumber, [&](const size_t thread)
+		{
+			const auto begin = size * thread / threadsNumber;
+			const auto end = size * (thread + 1) / threadsNumber;
+			//Считаем в локальный массив, чтобы потоки не писали в соседние ячейки общего
+			std::vector<size_t> localCounts(bucketsNumber, 0);
+			for (auto i = begin; i < end; ++i)
+			{
+				localCounts[findBucket(arrayElements[i])] += 1;
+			}
+			std::copy(localCounts.begin(), localCounts.end(), counts.begin() + thread * bucketsNumber);
+		});
+
+		//Корзины идут подряд, внутри корзины элементы раскладываются в порядке номеров потоков
+		std::vector<size_t> offsets(threadsNumber * bucketsNumber);
+		std::vector<size_t> bucketsBorders(bucketsNumber + 1, 0);
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < bucketsNumber; ++bucket)
+		{
+			bucketsBorders[bucket] = offset;
+			for (size_t thread = 0; thread < threadsNumber; ++thread)
+			{
+				offsets[thread * bucketsNumber + bucket] = offset;
+				offset += counts[thread * bucketsNumber + bucket];
+			}
+		}
+		bucketsBorders[bucketsNumber] = size;
+
+		//Буфер не инициализируется: элементы создаются в нём перемещением, поэтому конструктор по умолчанию у T не нужен
+		std::allocator<T> allocator;
+		auto* buffer = allocator.allocate(size);
+		runInThreads(threadsNumber, [&](const size_t thread)
+		{
+			const auto begin = size * thread / threadsNumber;
+			const auto end = size * (thread + 1) / threadsNumber;
+			std::vector<size_t> positions(offsets.begin() + thread * bucketsNumber, offsets.begin() + (thread + 1) * bucketsNumber);
+			for (auto i = begin; i < end; ++i)
+			{
+				new (buffer + positions[findBucket(arrayElements[i])]++) T(std::move(arrayElements[i]));
+			}
+		});
+		//Корзин между разделителями не больше, чем потоков: поток thread переносит обратно и сортирует корзину 2 * thread
+		//и переносит корзину равных 2 * thread + 1
+		runInThreads(threadsNumber, [&](const size_t thread)
+		{
+			const auto begin = bucketsBorders[std::min(2 * thread, bucketsNumber)];
+			const auto end = bucketsBorders[std::min(2 * thread + 2, bucketsNumber)];
+			std::move(buffer + begin, buffer + end, arrayElements.begin() + begin);
+			std::destroy(buffer + begin, buffer + end);
+			if (2 * thread < bucketsNumber)
+			{
+				sortSegment(arrayElements, begin, bucketsBorders[2 * thread + 1], less);
+			}
+		});
+		allocator.deallocate(buffer, size);
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::sortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		if constexpr (isRadixSortApplicable<T, Less>())
+		{
+			if (high - low >= RADIX_SORT_THRESHOLD && !isNearlySorted(arrayElements, low, high, less))
+			{
+				radixSortSegment(arrayElements, low, high);
+				return;
+			}
+		}
+		introSortSegment(arrayElements, low, high, less);
+	}
+
+
+
+	template <typename T>
+	void Sorting::radixSortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high)
+	{
+		static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Radix sort requires an integral type");
+		using Key = std::make_unsigned_t<T>;
+		constexpr size_t keyBits = sizeof(T) * 8;
+		constexpr auto digitBits = std::min(RADIX_DIGIT_BITS, keyBits);
+		constexpr size_t digitsNumber = (keyBits + digitBits - 1) / digitBits;
+		constexpr size_t bucketsNumber = size_t{ 1 } << digitBits;
+		constexpr auto signMask = std::is_signed_v<T> ? static_cast<Key>(uint64_t{ 1 } << (keyBits - 1)) : Key{ 0 };
+		const auto size = high - low;
+		if (size < 2)
+		{
+			return;
+		}
+		const auto digit = [](const T value, const size_t shift)
+		{
+			return static_cast<size_t>(static_cast<Key>(static_cast<Key>(value) ^ signMask) >> shift) & (bucketsNumber - 1);
+		};
+
+		//Количества всех разрядов подсчитываются за один проход
+		std::vector<size_t> counts(digitsNumber * bucketsNumber, 0);
+		for (auto i = low; i < high; ++i)
+		{
+			for (size_t digitIndex = 0; digitIndex < digitsNumber; ++digitIndex)
+			{
+				counts[digitIndex * bucketsNumber + digit(arrayElements[i], digitIndex * digitBits)] += 1;
+			}
+		}
+
+		std::unique_ptr<T[]> buffer(new T[size]);
+		auto* source = arrayElements.data() + low;
+		auto* target = buffer.get();
+		for (size_t digitIndex = 0; digitIndex < digitsNumber; ++digitIndex)
+		{
+			auto* positions = counts.data() + digitIndex * bucketsNumber;
+			const auto shift = digitIndex * digitBits;
+			//Если у всех чисел разряд одинаков, проход ничего не переставит
+			if (positions[digit(source[0], shift)] == size)
+			{
+				continue;
+			}
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < bucketsNumber; ++bucket)
+			{
+				const auto count = positions[bucket];
+				positions[bucket] = offset;
+				offset += count;
+			}
+			for (size_t i = 0; i < size; ++i)
+			{
+				target[positions[digit(source[i], shift)]++] = source[i];
+			}
+			std::swap(source, target);
+		}
+		if (source != arrayElements.data() + low)
+		{
+			std::copy(source, source + size, arrayElements.begin() + low);
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::introSortSegment(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		//Отрезки [low, high) и допустимая глубина разбиений для каждого
+		struct Segment
+		{
+			size_t low;
+			size_t high;
+			size_t depth;
+		};
+		size_t depthLimit = 0;
+		for (auto size = high - low; size > 1; size /= 2)
+		{
+			depthLimit += 2;
+		}
+		std::vector<Segment> segments{ { low, high, depthLimit } };
+		while (!segments.empty())
+		{
+			auto segment = segments.back();
+			segments.pop_back();
+			//Меньшую часть продолжаем разбивать сразу, большую откладываем в стек. Поэтому в стеке O(log n) отрезков.
+			while (segment.high - segment.low > INSERTION_SORT_THRESHOLD)
+			{
+				if (segment.depth == 0)
+				{
+					std::make_heap(arrayElements.begin() + segment.low, arrayElements.begin() + segment.high, less);
+					std::sort_heap(arrayElements.begin() + segment.low, arrayElements.begin() + segment.high, less);
+					segment.low = segment.high;
+					break;
+				}
+				segment.depth -= 1;
+				selectMainElement(arrayElements, segment.low, segment.high - 1, less);
+				const auto mainElementPosition = partition(arrayElements, segment.low, segment.high - 1, less);
+				if (mainElementPosition - segment.low < segment.high - mainElementPosition)
+				{
+					segments.push_back({ mainElementPosition + 1, segment.high, segment.depth });
+					segment.high = mainElementPosition;
+				}
+				else
+				{
+					segments.push_back({ segment.low, mainElementPosition, segment.depth });
+					segment.low = mainElementPosition + 1;
+				}
+			}
+			insertionSort(arrayElements, segment.low, segment.high, less);
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::insertionSort(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		for (auto i = low + 1; i < high; ++i)
+		{
+			if (!less(arrayElements[i], arrayElements[i - 1]))
+			{
+				continue;
+			}
+			auto value = std::move(arrayElements[i]);
+			auto j = i;
+			do
+			{
+				arrayElements[j] = std::move(arrayElements[j - 1]);
+				j -= 1;
+			} while (j > low && less(value, arrayElements[j - 1]));
+			arrayElements[j] = std::move(value);
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	bool Sorting::sortPresorted(std::vector<T>& arrayElements, const Less& less)
+	{
+		const auto size = arrayElements.size();
+		const auto limit = std::max(size / PRESORTED_RUNS_RATIO, size_t{ 2 });
+		size_t runsNumber = 0;
+		for (size_t runBegin = 0; runBegin < size; runsNumber += 1)
+		{
+			//На случайных данных средняя длина серии - около двух элементов, поэтому проход прерывается уже на первых 2 * limit элементах
+			if (runsNumber == limit)
+			{
+				return false;
+			}
+			//Сортировка не обязана быть устойчивой, поэтому убывающие серии могут содержать равные элементы:
+			//так развёрнутый массив с повторами остаётся одной серией
+			const auto run = findRun(arrayElements, runBegin, false, less);
+			if (run.second)
+			{
+				std::reverse(arrayElements.begin() + runBegin, arrayElements.begin() + run.first);
+			}
+			runBegin = run.first;
+		}
+		naturalMergeSort(arrayElements, less);
+		return true;
+	}
+
+
+
+	template <typename T, typename Less>
+	bool Sorting::isNearlySorted(const std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		const auto step = std::max((high - low - 1) / DISORDER_SAMPLE_SIZE, size_t{ 1 });
+		size_t pairsNumber = 0;
+		size_t descentsNumber = 0;
+		for (auto i = low; i + 1 < high && pairsNumber < DISORDER_SAMPLE_SIZE; i += step, ++pairsNumber)
+		{
+			descentsNumber += static_cast<size_t>(less(arrayElements[i + 1], arrayElements[i]));
+		}
+		return descentsNumber * NEARLY_SORTED_DESCENTS_RATIO < pairsNumber;
+	}
+
+
+
+	template <typename T, typename Less>
+	std::pair<size_t, bool> Sorting::findRun(const std::vector<T>& arrayElements, const size_t runBegin, const bool isStrict, const Less& less)
+	{
+		const auto size = arrayElements.size();
+		auto runEnd = runBegin + 1;
+		if (runEnd < size && less(arrayElements[runEnd], arrayElements[runBegin]))
+		{
+			while (runEnd < size && (isStrict ? less(arrayElements[runEnd], arrayElements[runEnd - 1]) : !less(arrayElements[runEnd - 1], arrayElements[runEnd])))
+			{
+				runEnd += 1;
+			}
+			return { runEnd, true };
+		}
+		while (runEnd < size && !less(arrayElements[runEnd], arrayElements[runEnd - 1]))
+		{
+			runEnd += 1;
+		}
+		return { runEnd, false };
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::selectMainElement(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		const auto mid = low + (high - low) / 2;
+		if (high - low >= NINTHER_THRESHOLD)
+		{
+			const auto step = (high - low) / 8;
+			sortThree(arrayElements, low, low + step, low + 2 * step, less);
+			sortThree(arrayElements, mid - step, mid, mid + step, less);
+			sortThree(arrayElements, high - 2 * step, high - step, high, less);
+			sortThree(arrayElements, low + step, mid, high - step, less);
+		}
+		else
+		{
+			sortThree(arrayElements, low, mid, high, less);
+		}
+		std::swap(arrayElements[mid], arrayElements[high]);
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::sortThree(std::vector<T>& arrayElements, const size_t first, const size_t middle, const size_t last, const Less& less)
+	{
+		if (less(arrayElements[middle], arrayElements[first]))
+		{
+			std::swap(arrayElements[first], arrayElements[middle]);
+		}
+		if (less(arrayElements[last], arrayElements[middle]))
+		{
+			std::swap(arrayElements[middle], arrayElements[last]);
+			if (less(arrayElements[middle], arrayElements[first]))
+			{
+				std::swap(arrayElements[first], arrayElements[middle]);
+			}
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	size_t Sorting::partition(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		if constexpr (isBlockPartitionApplicable<T, Less>())
+		{
+			return partitionBlock(arrayElements, low, high, less);
+		}
+		else
+		{
+			return partitionHoare(arrayElements, low, high, high, less);
+		}
+	}
+
+
+
+	template <typename T, typename Less>
+	size_t Sorting::partitionBlock(std::vector<T>& arrayElements, const size_t low, const size_t high, const Less& less)
+	{
+		/*
+		 * Пока нерассмотренная часть [leftIterator, rightEnd) содержит хотя бы два блока, для блока у каждого её конца
+		 * записываем смещения элементов, стоящих не на своей стороне. Запись не содержит ветвлений: смещение пишется всегда,
+		 * а счётчик увеличивается на результат сравнения. Затем меняем местами пары таких элементов из двух буферов.
+		 * Блок, все неправильные элементы которого обработаны, считается рассмотренным. Остаток разбивается методом Хоара.
+		 */
+		const auto pivot = arrayElements[high];
+		uint8_t leftOffsets[PARTITION_BLOCK_SIZE];
+		uint8_t rightOffsets[PARTITION_BLOCK_SIZE];
+		size_t leftNumber = 0;
+		size_t rightNumber = 0;
+		size_t leftStart = 0;
+		size_t rightStart = 0;
+		auto leftIterator = low;
+		auto rightEnd = high;
+		while (rightEnd - leftIterator >= 2 * PARTITION_BLOCK_SIZE)
+		{
+			if (leftNumber == 0)
+			{
+				leftStart = 0;
+				for (size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+				{
+					leftOffsets[leftNumber] = static_cast<uint8_t>(i);
+					leftNumber += !less(arrayElements[leftIterator + i], pivot);
+				}
+			}
+			if (rightNumber == 0)
+			{
+				rightStart = 0;
+				for (size_t i = 0; i < PARTITION_BLOCK_SIZE; ++i)
+				{
+					rightOffsets[rightNumber] = static_cast<uint8_t>(i);
+					rightNumber += !less(pivot, arrayElements[rightEnd - 1 - i]);
+				}
+			}
+			const auto swapsNumber = std::min(leftNumber, rightNumber);
+			for (size_t i = 0; i < swapsNumber; ++i)
+			{
+				std::swap(arrayElements[leftIterator + leftOffsets[leftStart + i]], arrayElements[rightEnd - 1 - rightOffsets[rightStart + i]]);
+			}
+			leftNumber -= swapsNumber;
+			rightNumber -= swapsNumber;
+			leftStart += swapsNumber;
+			rightStart += swapsNumber;
+			if (leftNumber == 0)
+			{
+				leftIterator += PARTITION_BLOCK_SIZE;
+			}
+			if (rightNumber == 0)
+			{
+				rightEnd -= PARTITION_BLOCK_SIZE;
+			}
+		}
+		//В остатке могут быть неправильно расположенные элементы одного из блоков, поэтому он разбивается целиком
+		return partitionHoare(arrayElements, leftIterator, rightEnd, high, less);
+	}
+
+
+
+	template <typename T, typename Less>
+	size_t Sorting::partitionHoare(std::vector<T>& arrayElements, size_t leftIterator, size_t rightEnd, const size_t high, const Less& less)
+	{
+		const auto& pivot = arrayElements[high];
+		while (true)
+		{
+			while (leftIterator < rightEnd && less(arrayElements[leftIterator], pivot))
+			{
+				leftIterator += 1;
+			}
+			while (leftIterator < rightEnd && less(pivot, arrayElements[rightEnd - 1]))
+			{
+				rightEnd -= 1;
+			}
+			if (leftIterator >= rightEnd)
+			{
+				break;
+			}
+			std::swap(arrayElements[leftIterator], arrayElements[rightEnd - 1]);
+			leftIterator += 1;
+			rightEnd -= 1;
+		}
+		std::swap(arrayElements[leftIterator], arrayElements[high]);
+		return leftIterator;
+	}
+
+
+
+	template <typename T, typename Less>
+	void Sorting::mergeAdjacent(std::vector<T>& arrayElements, size_t low, const size_t middle, size_t high, std::vector<T>& buffer, const Less& less)
+	{
+		const auto begin = arrayElements.begin();
+		//Элементы левого отрезка, не большие первого элемента правого, уже стоят на своих местах
+		low = static_cast<size_t>(gallopUpperBound(begin + low, begin + middle, arrayElements[middle], less) - begin);
+		if (low == middle)
+		{
+			return;
+		}
+		//Элементы правого отрезка, не меньшие последнего элемента левого, тоже уже стоят на своих местах
+		high = static_cast<size_t>(gallopLowerBound(begin + middle, begin + high, arrayElements[middle - 1], less) - begin);
+
+		buffer.assign(std::make_move_iterator(begin + low), std::make_move_iterator(begin + middle));
+		auto leftIterator = buffer.begin();
+		auto rightIterator = begin + middle;
+		auto mergeIterator = begin + low;
+		const auto rightEnd = begin + high;
+		size_t leftWins = 0;
+		size_t rightWins = 0;
+		while (leftIterator != buffer.end() && rightIterator != rightEnd)
+		{
+			//При равенстве берём элемент левого отрезка, поэтому слияние устойчиво
+			if (less(*rightIterator, *leftIterator))
+			{
+				*mergeIterator++ = std::move(*rightIterator++);
+				rightWins += 1;
+				leftWins = 0;
+			}
+			else
+			{
+				*mergeIterator++ = std::move(*leftIterator++);
+				leftWins += 1;
+				rightWins = 0;
+			}
+			if (leftIterator == buffer.end() || rightIterator == rightEnd)
+			{
+				break;
+			}
+			if (rightWins >= MINIMAL_GALLOP)
+			{
+				//Галоп по правому отрезку: его элементы, меньшие текущего элемента левого, переносятся одним блоком
+				const auto gallopEnd = gallopLowerBound(rightIterator, rightEnd, *leftIterator, less);
+				mergeIterator = std::move(rightIterator, gallopEnd, mergeIterator);
+				rightIterator = gallopEnd;
+				rightWins = 0;
+			}
+			else if (leftWins >= MINIMAL_GALLOP)
+			{
+				//Галоп по левому отрезку: его элементы, не большие текущего элемента правого, переносятся одним блоком
+				const auto gallopEnd = gallopUpperBound(leftIterator, buffer.end(), *rightIterator, less);
+				mergeIterator = std::move(leftIterator, gallopEnd, mergeIterator);
+				leftIterator = gallopEnd;
+				leftWins = 0;
+			}
+		}
+		//Остаток правого отрезка уже стоит на месте, переносим только остаток левого
+		std::move(leftIterator, buffer.end(), mergeIterator);
+	}
+
+
+
+	template <typename RandomIt, typename T, typename Less>
+	RandomIt Sorting::gallopUpperBound(RandomIt first, RandomIt last, const T& key, const Less& less)
+	{
+		const auto size = static_cast<size_t>(last - first);
+		//Проверяем элементы с индексами 0, 1, 3, 7, ..., пока они не больше key
+		size_t bound = 1;
+		while (bound <= size && !less(key, first[bound - 1]))
+		{
+			bound *= 2;
+		}
+		return std::upper_bound(first + bound / 2, first + std::min(bound, size), key, less);
+	}
+
+
+
+	template <typename RandomIt, typename T, typename Less>
+	RandomIt Sorting::gallopLowerBound(RandomIt first, RandomIt last, const T& key, const Less& less)
+	{
+		const auto size = static_cast<size_t>(last - first);
+		//Проверяем элементы с индексами 0, 1, 3, 7, ..., пока они меньше key
+		size_t bound = 1;
+		while (bound <= size && less(first[bound - 1], key))
+		{
+			bound *= 2;
+		}
+		return std::lower_bound(first + bound / 2, first + std::min(bound, size), key, less);
+	}
+
+
+
+	template <typename Function>
+	void Sorting::runInThreads(const size_t threadsNumber, const Function& function)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(threadsNumber - 1);
+		for (size_t thread = 1; thread < threadsNumber; ++thread)
+		{
+			threads.emplace_back(function, thread);
+		}
+		function(0);
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+}
@@ -0,0 +1,359 @@
+﻿/*
+ * Задача № 5. Соревнование по сортировке.
+ * Дан массив целых чисел. Требуется отсортировать его по неубыванию как можно быстрее.
+ *
+ * Формат входных данных: в файле input.txt записано количество чисел n, затем n целых чисел.
+ * Формат выходных данных: n чисел в порядке неубывания через пробел.
+ */
+
+/*
+ * Оценка сложности алгоритма.
+ * Сортировка выбирается автоматически (custom_algorithms::Sorting::sort):
+ * - отсортированный или развёрнутый массив распознаётся за O(n), массив из r серий сортируется слиянием за O(n log r);
+ * - целые числа сортируются поразрядной сортировкой за O(n * sizeof(T)) с дополнительной памятью O(n);
+ * - почти упорядоченный массив целых чисел (спусков меньше четверти в выборке соседних пар) сортируется интроспективной сортировкой;
+ * - остальные типы сортируются интроспективной сортировкой: в худшем случае O(n log n), дополнительная память O(log n);
+ * - большой массив на нескольких ядрах сортируется параллельной сортировкой выборкой.
+ */
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include "Sorting.hpp"
+
+
+/**
+ * \brief Генерирует массивы разных видов для проверки и замеров сортировок.
+ * \param kind Вид массива: 0 - случайный, 1 - отсортированный, 2 - развёрнутый, 3 - почти отсортированный,
+ * 4 - с небольшим числом различных значений, 5 - "органные трубы", 6 - из нескольких отсортированных серий.
+ * \param size Размер массива.
+ * \param generator Генератор случайных чисел.
+ * \param makeValue Функция, строящая элемент по случайному числу.
+ */
+template<typename T>
+std::vector<T> generateArray(const size_t kind, const size_t size, std::mt19937_64& generator, const std::function<T(uint64_t)>& makeValue)
+{
+	std::vector<T> numbers(size);
+	for (auto& number : numbers)
+	{
+		number = makeValue(kind == 4 ? generator() % 16 : generator());
+	}
+	switch (kind)
+	{
+	case 1:
+		std::sort(numbers.begin(), numbers.end());
+		break;
+	case 2:
+		std::sort(numbers.begin(), numbers.end());
+		std::reverse(numbers.begin(), numbers.end());
+		break;
+	case 3:
+		std::sort(numbers.begin(), numbers.end());
+		for (size_t i = 0; i < size / 100 && size > 0; ++i)
+		{
+			std::swap(numbers[generator() % size], numbers[generator() % size]);
+		}
+		break;
+	case 5:
+		std::sort(numbers.begin(), numbers.begin() + size / 2);
+		std::sort(numbers.begin() + size / 2, numbers.end());
+		std::reverse(numbers.begin() + size / 2, numbers.end());
+		break;
+	case 6:
+		for (size_t run = 0; run < 8; ++run)
+		{
+			std::sort(numbers.begin() + size * run / 8, numbers.begin() + size * (run + 1) / 8);
+		}
+		break;
+	default:
+		break;
+	}
+	return numbers;
+}
+
+/**
+ * \brief Количество видов массивов, которые умеет строить generateArray.
+ */
+const size_t ARRAY_KINDS_NUMBER = 7;
+
+
+template<typename T, typename Less = std::less<T>>
+void checkSorting(const std::vector<T>& numbers, const std::function<void(std::vector<T>&)>& sort, const Less& less = Less())
+{
+	auto expected = numbers;
+	std::sort(expected.begin(), expected.end(), less);
+	auto actual = numbers;
+	sort(actual);
+	assert(actual == expected);
+}
+
+
+template<typename T>
+void checkSortingAllKinds(std::mt19937_64& generator, const std::function<T(uint64_t)>& makeValue)
+{
+	for (size_t size : { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 5000, 100000 })
+	{
+		for (size_t kind = 0; kind < ARRAY_KINDS_NUMBER; ++kind)
+		{
+			const auto numbers = generateArray<T>(kind, size, generator, makeValue);
+			checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::sort(array); });
+			checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::introSort(array); });
+			checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::naturalMergeSort(array); });
+			checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::parallelSampleSort(array, 3); });
+			checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::sort(array, std::greater<T>()); }, std::greater<T>());
+		}
+	}
+}
+
+
+void SortingTest_matchesStdSort()
+{
+	std::mt19937_64 generator(42);
+	checkSortingAllKinds<uint32_t>(generator, [](uint64_t value) { return static_cast<uint32_t>(value); });
+	checkSortingAllKinds<int64_t>(generator, [](uint64_t value) { return static_cast<int64_t>(value); });
+	checkSortingAllKinds<double>(generator, [](uint64_t value) { return static_cast<double>(static_cast<int64_t>(value)) / 1e9; });
+	checkSortingAllKinds<std::string>(generator, [](uint64_t value) { return std::to_string(value % 100000); });
+
+	//Естественная сортировка слиянием устойчива: сравниваем только ключи, а порядок равных должен совпасть с std::stable_sort
+	for (size_t kind = 0; kind < ARRAY_KINDS_NUMBER; ++kind)
+	{
+		auto numbers = generateArray<std::pair<uint32_t, size_t>>(kind, 10000, generator, [](uint64_t value) { return std::make_pair(static_cast<uint32_t>(value % 100), size_t{ 0 }); });
+		for (size_t i = 0; i < numbers.size(); ++i)
+		{
+			numbers[i].second = i;
+		}
+		const auto lessByKey = [](const std::pair<uint32_t, size_t>& lhs, const std::pair<uint32_t, size_t>& rhs) { return lhs.first < rhs.first; };
+		auto expected = numbers;
+		std::stable_sort(expected.begin(), expected.end(), lessByKey);
+		custom_algorithms::Sorting::naturalMergeSort(numbers, lessByKey);
+		assert(numbers == expected);
+	}
+}
+
+
+template<typename T>
+void checkRadixSort(std::mt19937_64& generator, const size_t size, const uint64_t modulo)
+{
+	std::vector<T> numbers(size);
+	for (auto& number : numbers)
+	{
+		number = static_cast<T>(modulo == 0 ? generator() : generator() % modulo);
+	}
+	checkSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::radixSort(array); });
+}
+
+
+void SortingTest_radixSortMatchesStdSort()
+{
+	std::mt19937_64 generator(42);
+	for (size_t size : { 0, 1, 2, 1000, 100000 })
+	{
+		for (uint64_t modulo : { 0, 1, 2, 1000 })
+		{
+			checkRadixSort<int8_t>(generator, size, modulo);
+			checkRadixSort<uint16_t>(generator, size, modulo);
+			checkRadixSort<int32_t>(generator, size, modulo);
+			checkRadixSort<uint32_t>(generator, size, modulo);
+			checkRadixSort<int64_t>(generator, size, modulo);
+			checkRadixSort<uint64_t>(generator, size, modulo);
+		}
+	}
+	//Крайние значения знаковых типов
+	std::vector<int64_t> extremes{ INT64_MAX, INT64_MIN, -1, 0, 1, INT64_MIN + 1, INT64_MAX - 1 };
+	checkSorting<int64_t>(extremes, [](std::vector<int64_t>& array) { custom_algorithms::Sorting::radixSort(array); });
+}
+
+
+void SortingTest_parallelSampleSortMatchesStdSort()
+{
+	std::mt19937_64 generator(42);
+	for (size_t threadsNumber : { 1, 2, 3, 8 })
+	{
+		for (size_t kind = 0; kind < ARRAY_KINDS_NUMBER; ++kind)
+		{
+			const auto numbers = generateArray<uint64_t>(kind, 300000, generator, [](uint64_t value) { return value; });
+			checkSorting<uint64_t>(numbers, [threadsNumber](std::vector<uint64_t>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber); });
+			const auto strings = generateArray<std::string>(kind, 30000, generator, [](uint64_t value) { return std::to_string(value); });
+			checkSorting<std::string>(strings, [threadsNumber](std::vector<std::string>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber); });
+		}
+		//Частый ключ: все элементы равны или 90% элементов равны 42. Равные разделителю элементы собираются в свою корзину.
+		for (uint64_t heavyPercent : { 100, 90 })
+		{
+			std::vector<uint64_t> numbers(300000);
+			for (auto& number : numbers)
+			{
+				number = generator() % 100 < heavyPercent ? 42 : generator() % 1000;
+			}
+			checkSorting<uint64_t>(numbers, [threadsNumber](std::vector<uint64_t>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber); });
+			checkSorting<uint64_t>(numbers, [threadsNumber](std::vector<uint64_t>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber, std::greater<uint64_t>()); }, std::greater<uint64_t>());
+		}
+	}
+	//Тип без конструктора по умолчанию
+	struct Key
+	{
+		explicit Key(const uint64_t value) : value(value) {}
+		bool operator<(const Key& other) const { return value < other.value; }
+		bool operator==(const Key& other) const { return value == other.value; }
+		uint64_t value;
+	};
+	std::vector<Key> keys;
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		keys.emplace_back(generator() % 50);
+	}
+	checkSorting<Key>(keys, [](std::vector<Key>& array) { custom_algorithms::Sorting::parallelSampleSort(array, 4); });
+}
+
+
+/**
+ * \brief Замер времени работы сортировки одного массива. Массив копируется, время копирования не учитывается.
+ * \return Время работы в миллисекундах.
+ */
+template<typename T>
+double measureSorting(const std::vector<T>& numbers, const std::function<void(std::vector<T>&)>& sort)
+{
+	auto array = numbers;
+	const auto start = std::chrono::steady_clock::now();
+	sort(array);
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+
+template<typename T>
+void benchmarkSortingAllKinds(const std::string& typeName, const size_t size, const std::function<T(uint64_t)>& makeValue)
+{
+	const char* kindNames[ARRAY_KINDS_NUMBER] = { "random", "sorted", "reversed", "nearly sorted", "few unique", "organ pipe", "8 runs" };
+	std::mt19937_64 generator(42);
+	for (size_t kind = 0; kind < ARRAY_KINDS_NUMBER; ++kind)
+	{
+		const auto numbers = generateArray<T>(kind, size, generator, makeValue);
+		std::cout << typeName << ", n = " << size << ", " << kindNames[kind]
+			<< ": std::sort " << measureSorting<T>(numbers, [](std::vector<T>& array) { std::sort(array.begin(), array.end()); }) << " ms"
+			<< ", std::stable_sort " << measureSorting<T>(numbers, [](std::vector<T>& array) { std::stable_sort(array.begin(), array.end()); }) << " ms"
+			<< ", Sorting::sort " << measureSorting<T>(numbers, [](std::vector<T>& array) { custom_algorithms::Sorting::sort(array); }) << " ms" << std::endl;
+	}
+}
+
+
+void SortingBenchmark_integers()
+{
+	benchmarkSortingAllKinds<uint32_t>("uint32_t", 10000000, [](uint64_t value) { return static_cast<uint32_t>(value); });
+	benchmarkSortingAllKinds<uint64_t>("uint64_t", 10000000, [](uint64_t value) { return value; });
+	benchmarkSortingAllKinds<int64_t>("int64_t", 10000000, [](uint64_t value) { return static_cast<int64_t>(value); });
+}
+
+
+void SortingBenchmark_generic()
+{
+	benchmarkSortingAllKinds<double>("double", 10000000, [](uint64_t value) { return static_cast<double>(static_cast<int64_t>(value)) / 1e9; });
+	benchmarkSortingAllKinds<std::string>("std::string", 1000000, [](uint64_t value) { return std::to_string(value); });
+}
+
+
+void SortingBenchmark_algorithms()
+{
+	std::mt19937_64 generator(42);
+	for (size_t size : { 1000, 100000, 10000000 })
+	{
+		const size_t repeats = 10000000 / size;
+		double stdTime = 0;
+		double introTime = 0;
+		double radixTime = 0;
+		for (size_t repeat = 0; repeat < repeats; ++repeat)
+		{
+			const auto numbers = generateArray<uint32_t>(0, size, generator, [](uint64_t value) { return static_cast<uint32_t>(value); });
+			stdTime += measureSorting<uint32_t>(numbers, [](std::vector<uint32_t>& array) { std::sort(array.begin(), array.end()); });
+			introTime += measureSorting<uint32_t>(numbers, [](std::vector<uint32_t>& array) { custom_algorithms::Sorting::introSort(array); });
+			radixTime += measureSorting<uint32_t>(numbers, [](std::vector<uint32_t>& array) { custom_algorithms::Sorting::radixSort(array); });
+		}
+		std::cout << "uint32_t, n = " << size << ": std::sort " << stdTime / repeats << " ms, introsort " << introTime / repeats
+			<< " ms, radix sort " << radixTime / repeats << " ms" << std::endl;
+	}
+}
+
+
+void SortingBenchmark_parallel()
+{
+	const size_t n = 50000000;
+	std::mt19937_64 generator(42);
+	const auto numbers = generateArray<double>(0, n, generator, [](uint64_t value) { return static_cast<double>(value); });
+	std::cout << "double, n = " << n << ", std::sort: "
+		<< measureSorting<double>(numbers, [](std::vector<double>& array) { std::sort(array.begin(), array.end()); }) << " ms" << std::endl;
+	for (size_t threadsNumber : { 1, 2, 4, 8, 16 })
+	{
+		std::cout << "double, n = " << n << ", " << threadsNumber << " threads: "
+			<< measureSorting<double>(numbers, [threadsNumber](std::vector<double>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber); }) << " ms" << std::endl;
+	}
+	//Частый ключ: без отдельной корзины равных разделителю элементов почти весь массив сортировал бы один поток
+	const size_t heavySize = 1 << 23;
+	for (uint64_t heavyPercent : { 100, 90 })
+	{
+		std::vector<uint64_t> heavy(heavySize);
+		for (auto& number : heavy)
+		{
+			number = generator() % 100 < heavyPercent ? 42 : generator();
+		}
+		std::cout << "uint64_t, n = " << heavySize << ", " << heavyPercent << "% equal to 42, std::sort: "
+			<< measureSorting<uint64_t>(heavy, [](std::vector<uint64_t>& array) { std::sort(array.begin(), array.end()); }) << " ms";
+		for (size_t threadsNumber : { 1, 4, 8 })
+		{
+			std::cout << ", " << threadsNumber << " threads: "
+				<< measureSorting<uint64_t>(heavy, [threadsNumber](std::vector<uint64_t>& array) { custom_algorithms::Sorting::parallelSampleSort(array, threadsNumber); }) << " ms";
+		}
+		std::cout << std::endl;
+	}
+}
+
+
+int main()
+{
+	const auto is_test = false;
+	if (is_test)
+	{
+		SortingTest_matchesStdSort();
+		SortingTest_radixSortMatchesStdSort();
+		SortingTest_parallelSampleSortMatchesStdSort();
+		return 0;
+	}
+	const auto is_benchmark = false;
+	if (is_benchmark)
+	{
+		SortingBenchmark_algorithms();
+		SortingBenchmark_integers();
+		SortingBenchmark_generic();
+		SortingBenchmark_parallel();
+		return 0;
+	}
+
+	std::ifstream in;
+	try
+	{
+		in.open("input.txt");
+	}
+	catch (...)
+	{
+		return 1;
+	}
+	size_t n{ 0 };
+	in >> n;
+	std::vector<int64_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		in >> number;
+	}
+	in.close();
+	custom_algorithms::Sorting::sort(numbers);
+	for (const auto number : numbers)
+	{
+		std::cout << number << ' ';
+	}
+	return 0;
+}
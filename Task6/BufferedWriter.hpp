@@ -0,0 +1,92 @@
+﻿#pragma once
+#include <cstdio>
+#include <vector>
+#include <charconv>
+#include <type_traits>
+#include <cassert>
+
+namespace custom_algorithms
+{
+	/**
+	 * \brief Буферизованный вывод целых чисел и символов в поток FILE*.
+	 * \brief Числа форматируются std::to_chars прямо в буфер, буфер сбрасывается в поток целиком одним вызовом fwrite,
+	 * \brief когда в нём не остаётся места под очередное число, при вызове flush и в деструкторе.
+	 */
+	class BufferedWriter
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param stream Поток, в который выполняется вывод.
+		 * \param capacity Размер буфера в байтах.
+		 */
+		explicit BufferedWriter(FILE* stream = stdout, size_t capacity = DEFAULT_CAPACITY) : stream_(stream), buffer_(capacity)
+		{
+			assert(capacity >= MAX_NUMBER_LENGTH);
+		}
+		~BufferedWriter() { flush(); }
+
+		BufferedWriter(const BufferedWriter& other) = delete;
+		BufferedWriter(BufferedWriter&& other) noexcept = delete;
+		BufferedWriter& operator=(const BufferedWriter& other) = delete;
+		BufferedWriter& operator=(BufferedWriter&& other) noexcept = delete;
+
+		/**
+		 * \brief Вывод целого числа в десятичной записи.
+		 * \tparam Integer Целочисленный тип.
+		 */
+		template<typename Integer>
+		void write(Integer number)
+		{
+			static_assert(std::is_integral_v<Integer>, "BufferedWriter::write expects an integer");
+			if (buffer_.size() - size_ < MAX_NUMBER_LENGTH)
+			{
+				flush();
+			}
+			const auto result = std::to_chars(buffer_.data() + size_, buffer_.data() + buffer_.size(), number);
+			size_ = static_cast<size_t>(result.ptr - buffer_.data());
+		}
+
+		/**
+		 * \brief Вывод одного символа.
+		 */
+		void put(const char symbol)
+		{
+			if (size_ == buffer_.size())
+			{
+				flush();
+			}
+			buffer_[size_++] = symbol;
+		}
+
+		/**
+		 * \brief Запись содержимого буфера в поток.
+		 */
+		void flush()
+		{
+			if (size_ != 0)
+			{
+				std::fwrite(buffer_.data(), 1, size_, stream_);
+				size_ = 0;
+			}
+			std::fflush(stream_);
+		}
+
+	private:
+		/**
+		 * \brief Размер буфера по умолчанию.
+		 */
+		static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+		/**
+		 * \brief Наибольшая длина десятичной записи 64-битного числа со знаком.
+		 */
+		static constexpr size_t MAX_NUMBER_LENGTH = 20;
+
+		FILE* stream_;
+		std::vector<char> buffer_;
+		/**
+		 * \brief Количество занятых байт буфера.
+		 */
+		size_t size_{ 0 };
+	};
+}
@@ -0,0 +1,194 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cassert>
+#include "InsertionPlaces.hpp"
+#include "MappedBinarySearchTree.hpp"
+
+namespace custom_containers
+{
+	/**
+	 * \brief Двоичное дерево поиска с наивной вставкой, хранящее узлы в трёх параллельных массивах: ключи, левые и правые потомки.
+	 * \brief Потомки задаются 32-битными индексами. Узел с индексом 0 - корень, он не бывает потомком, поэтому индекс 0 означает
+	 * \brief отсутствие потомка. Узел занимает sizeof(T) + 8 байт без накладных расходов на выделение памяти.
+	 * \brief Вставка и обход в ширину ведут себя так же, как в BinarySearchTree.
+	 * \tparam T Тип элементов, хранящихся в дереве.
+	 */
+	template<typename T>
+	class CompactBinarySearchTree
+	{
+	public:
+		CompactBinarySearchTree() = default;
+		explicit CompactBinarySearchTree(const std::function<bool(const T& lhs, const T& rhs)>& less) : less_(less) {}
+		~CompactBinarySearchTree() = default;
+		CompactBinarySearchTree(const CompactBinarySearchTree& other) = delete;
+		CompactBinarySearchTree(CompactBinarySearchTree&& other) noexcept = delete;
+		CompactBinarySearchTree& operator=(const CompactBinarySearchTree& other) = delete;
+		CompactBinarySearchTree& operator=(CompactBinarySearchTree&& other) noexcept = delete;
+
+		/**
+		 * \brief Обход дерева в ширину.
+		 * \tparam Action Тип функции, выполняемой над элементами. Принимает T&.
+		 * \param action Функция, выполняемая над элементами.
+		 */
+		template<typename Action>
+		void bfs(Action&& action);
+		/**
+		 * \brief Вставка элемента в дерево. Равные элементы попадают в правое поддерево.
+		 * \param value Вставляемый элемент.
+		 */
+		void insert(const T& value);
+		/**
+		 * \brief Построение дерева той же формы, что и вставка элементов values по порядку, за O(n log n) при любом их порядке.
+		 * \param values Вставляемые элементы. Дерево должно быть пустым.
+		 */
+		void build(const std::vector<T>& values);
+		/**
+		 * \brief Резервирование памяти под заданное количество узлов.
+		 * \param capacity Ожидаемое количество узлов.
+		 */
+		void reserve(size_t capacity);
+		/**
+		 * \brief Запись дерева в файл, который открывает MappedBinarySearchTree. Узлы перенумеровываются в порядке обхода в ширину.
+		 * \param path Путь к файлу.
+		 * \return True, если файл записан, иначе - false.
+		 */
+		[[nodiscard]] bool save(const std::string& path) const;
+		/**
+		 * \brief Копирование отображённого дерева для продолжения вставки: проверка индексов потомков и три копирования массивов без спуска.
+		 * \param mapped Отображённое дерево. Дерево должно быть пустым.
+		 * \return True, если индексы потомков в файле верны, иначе - false (дерево остаётся пустым).
+		 */
+		[[nodiscard]] bool materialize(const MappedBinarySearchTree<T>& mapped);
+		/**
+		 * \brief Количество элементов в дереве.
+		 */
+		[[nodiscard]] size_t size() const { return keys_.size(); }
+
+	private:
+		/**
+		 * \brief Индекс, означающий отсутствие потомка.
+		 */
+		static constexpr uint32_t NO_CHILD = 0;
+
+		std::vector<T> keys_;
+		std::vector<uint32_t> left_;
+		std::vector<uint32_t> right_;
+		std::function<bool(const T& lhs, const T& rhs)> less_{ std::less<T>() };
+	};
+
+	template <typename T>
+	template <typename Action>
+	void CompactBinarySearchTree<T>::bfs(Action&& action)
+	{
+		//Каждый узел попадает в очередь ровно один раз, поэтому очередь - массив размера n с указателями начала и конца
+		std::vector<uint32_t> queue(keys_.size());
+		size_t head = 0;
+		size_t tail = 0;
+		if (!keys_.empty())
+		{
+			queue[tail++] = 0;
+		}
+		while (head < tail)
+		{
+			const auto node = queue[head++];
+			if (left_[node] != NO_CHILD)
+			{
+				queue[tail++] = left_[node];
+			}
+			if (right_[node] != NO_CHILD)
+			{
+				queue[tail++] = right_[node];
+			}
+			action(keys_[node]);
+		}
+	}
+
+	template <typename T>
+	void CompactBinarySearchTree<T>::insert(const T& value)
+	{
+		assert(keys_.size() < UINT32_MAX);
+		const auto node = static_cast<uint32_t>(keys_.size());
+		if (node != 0)
+		{
+			uint32_t parent = 0;
+			while (true)
+			{
+				auto& child = less_(value, keys_[parent]) ? left_[parent] : right_[parent];
+				if (child == NO_CHILD)
+				{
+					child = node;
+					break;
+				}
+				parent = child;
+			}
+		}
+		keys_.push_back(value);
+		left_.push_back(NO_CHILD);
+		right_.push_back(NO_CHILD);
+	}
+
+	template <typename T>
+	void CompactBinarySearchTree<T>::build(const std::vector<T>& values)
+	{
+		assert(keys_.empty());
+		const auto places = custom_algorithms::calculateInsertionPlaces(values, less_);
+		keys_ = values;
+		left_.assign(values.size(), NO_CHILD);
+		right_.assign(values.size(), NO_CHILD);
+		for (uint32_t node = 1; node < places.size(); ++node)
+		{
+			(places[node].isLeft ? left_ : right_)[places[node].parent] = node;
+		}
+	}
+
+	template <typename T>
+	void CompactBinarySearchTree<T>::reserve(const size_t capacity)
+	{
+		keys_.reserve(capacity);
+		left_.reserve(capacity);
+		right_.reserve(capacity);
+	}
+
+	template <typename T>
+	bool CompactBinarySearchTree<T>::save(const std::string& path) const
+	{
+		//order[i] - исходный индекс узла с номером i в порядке обхода в ширину
+		std::vector<uint32_t> order(keys_.size());
+		std::vector<T> keys(keys_.size());
+		std::vector<uint32_t> left(keys_.size(), NO_CHILD);
+		std::vector<uint32_t> right(keys_.size(), NO_CHILD);
+		uint32_t tail = keys_.empty() ? 0 : 1;
+		for (uint32_t head = 0; head < tail; ++head)
+		{
+			const auto node = order[head];
+			keys[head] = keys_[node];
+			if (left_[node] != NO_CHILD)
+			{
+				left[head] = tail;
+				order[tail++] = left_[node];
+			}
+			if (right_[node] != NO_CHILD)
+			{
+				right[head] = tail;
+				order[tail++] = right_[node];
+			}
+		}
+		return writeTreeFile(path, keys, left, right);
+	}
+
+	template <typename T>
+	bool CompactBinarySearchTree<T>::materialize(const MappedBinarySearchTree<T>& mapped)
+	{
+		assert(keys_.empty());
+		if (!mapped.hasValidChildren())
+		{
+			return false;
+		}
+		keys_.assign(mapped.keys(), mapped.keys() + mapped.size());
+		left_.assign(mapped.left(), mapped.left() + mapped.size());
+		right_.assign(mapped.right(), mapped.right() + mapped.size());
+		return true;
+	}
+}
@@ -0,0 +1,234 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#ifdef _MSC_VER
+#include <xmmintrin.h>
+#endif
+
+namespace custom_containers
+{
+	/**
+	 * \brief Неизменяемый снимок упорядоченного набора элементов в раскладке Эйтцингера (Eytzinger) для быстрого поиска.
+	 * \brief Элементы лежат в массиве в порядке обхода в ширину идеально сбалансированного дерева поиска: потомки позиции k -
+	 * \brief позиции 2k и 2k + 1. Поиск спускается по массиву без ветвлений, а узлы на четыре уровня ниже текущего
+	 * \brief загружаются в кеш заранее (prefetch): они лежат подряд, а массив выровнен по границе кеш-линии, поэтому
+	 * \brief для элементов размером 4 байта (int32_t, float) все 16 таких узлов попадают в одну кеш-линию.
+	 * \brief Поиск: O(log n), обход диапазона из m элементов: O(log n + m).
+	 * \tparam T Тип элементов.
+	 * \tparam Less Тип функции сравнения.
+	 */
+	template<typename T, typename Less = std::less<T>>
+	class EytzingerSnapshot
+	{
+	public:
+		/**
+		 * \brief Конструктор.
+		 * \param sortedValues Элементы, упорядоченные по неубыванию в смысле less. Равные элементы допускаются.
+		 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+		 */
+		explicit EytzingerSnapshot(const std::vector<T>& sortedValues, const Less& less = Less());
+		~EytzingerSnapshot() = default;
+
+		EytzingerSnapshot(const EytzingerSnapshot& other) = delete;
+		EytzingerSnapshot(EytzingerSnapshot&& other) noexcept = default;
+		EytzingerSnapshot& operator=(const EytzingerSnapshot& other) = delete;
+		EytzingerSnapshot& operator=(EytzingerSnapshot&& other) noexcept = default;
+
+		/**
+		 * \brief Проверяет, содержится ли элемент в снимке.
+		 * \param value Искомый элемент.
+		 * \return True, если в снимке есть элемент, равный value, иначе - false.
+		 */
+		[[nodiscard]] bool contains(const T& value) const;
+
+		/**
+		 * \brief Поиск наименьшего элемента, не меньшего value. Аналог std::lower_bound.
+		 * \param value Искомое значение.
+		 * \return Указатель на найденный элемент или nullptr, если все элементы меньше value.
+		 */
+		[[nodiscard]] const T* lowerBound(const T& value) const;
+
+		/**
+		 * \brief Обход элементов из диапазона [low, high) в порядке возрастания.
+		 * \tparam Visitor Тип функции, выполняемой над элементами.
+		 * \param low Нижняя граница диапазона (включительно).
+		 * \param high Верхняя граница диапазона (не включительно).
+		 * \param visit Функция, выполняемая над элементами.
+		 */
+		template<typename Visitor>
+		void forEachInRange(const T& low, const T& high, const Visitor& visit) const;
+
+		/**
+		 * \brief Количество элементов в снимке.
+		 */
+		[[nodiscard]] size_t size() const { return data_.size() - 1; }
+
+	private:
+		/**
+		 * \brief Раскладывает отсортированные элементы по позициям поддерева с корнем в position (обход в порядке возрастания).
+		 */
+		void fill(const std::vector<T>& sortedValues, size_t& nextValue, size_t position);
+
+		/**
+		 * \brief Позиция следующего по порядку элемента или 0, если position - позиция наибольшего.
+		 */
+		[[nodiscard]] size_t successor(size_t position) const;
+
+		/**
+		 * \brief Подъём к предку, для которого position лежит в левом поддереве: отбрасываются младшие единичные биты и ещё один бит.
+		 */
+		static size_t climbToLeftAncestor(size_t position);
+
+		/**
+		 * \brief Загрузка в кеш элементов, лежащих на PREFETCH_LEVELS уровней ниже позиции position.
+		 */
+		void prefetch(size_t position) const;
+
+		/**
+		 * \brief Количество уровней, на которое вперёд загружаются элементы. Потомки позиции k на четыре уровня ниже
+		 * \brief занимают 16 соседних позиций начиная с 16k. При выровненном массиве и sizeof(T) == 4 это ровно одна
+		 * \brief кеш-линия, для более крупных элементов загружается только первая из sizeof(T) / 4 линий.
+		 */
+		static constexpr size_t PREFETCH_LEVELS = 4;
+
+		/**
+		 * \brief Размер кеш-линии в байтах.
+		 */
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		/**
+		 * \brief Аллокатор, выделяющий память с выравниванием по границе кеш-линии.
+		 */
+		template<typename U>
+		struct CacheLineAllocator
+		{
+			using value_type = U;
+
+			CacheLineAllocator() noexcept = default;
+			template<typename V>
+			CacheLineAllocator(const CacheLineAllocator<V>&) noexcept {}
+
+			U* allocate(const size_t count)
+			{
+				return static_cast<U*>(::operator new(count * sizeof(U), std::align_val_t(std::max(CACHE_LINE_SIZE, alignof(U)))));
+			}
+			void deallocate(U* pointer, size_t) noexcept
+			{
+				::operator delete(pointer, std::align_val_t(std::max(CACHE_LINE_SIZE, alignof(U))));
+			}
+
+			template<typename V>
+			bool operator==(const CacheLineAllocator<V>&) const noexcept { return true; }
+			template<typename V>
+			bool operator!=(const CacheLineAllocator<V>&) const noexcept { return false; }
+		};
+
+		/**
+		 * \brief Элементы в раскладке Эйтцингера. Позиция 0 не используется.
+		 */
+		std::vector<T, CacheLineAllocator<T>> data_;
+		Less less_;
+	};
+
+	template <typename T, typename Less>
+	EytzingerSnapshot<T, Less>::EytzingerSnapshot(const std::vector<T>& sortedValues, const Less& less) : data_(sortedValues.size() + 1), less_(less)
+	{
+		assert(reinterpret_cast<uintptr_t>(data_.data()) % CACHE_LINE_SIZE == 0);
+		size_t nextValue = 0;
+		fill(sortedValues, nextValue, 1);
+		assert(nextValue == sortedValues.size());
+	}
+
+	template <typename T, typename Less>
+	bool EytzingerSnapshot<T, Less>::contains(const T& value) const
+	{
+		const auto* found = lowerBound(value);
+		return found != nullptr && !less_(value, *found);
+	}
+
+	template <typename T, typename Less>
+	const T* EytzingerSnapshot<T, Less>::lowerBound(const T& value) const
+	{
+		const auto size = data_.size() - 1;
+		size_t position = 1;
+		while (position <= size)
+		{
+			prefetch(position);
+			//Переход к левому (2k) или правому (2k + 1) потомку без ветвления
+			position = 2 * position + static_cast<size_t>(less_(data_[position], value));
+		}
+		//Ответ - последний узел, в котором спуск ушёл налево
+		position = climbToLeftAncestor(position);
+		return position == 0 ? nullptr : &data_[position];
+	}
+
+	template <typename T, typename Less>
+	template <typename Visitor>
+	void EytzingerSnapshot<T, Less>::forEachInRange(const T& low, const T& high, const Visitor& visit) const
+	{
+		const auto* first = lowerBound(low);
+		if (first == nullptr)
+		{
+			return;
+		}
+		for (auto position = static_cast<size_t>(first - data_.data()); position != 0 && less_(data_[position], high); position = successor(position))
+		{
+			visit(data_[position]);
+		}
+	}
+
+	template <typename T, typename Less>
+	void EytzingerSnapshot<T, Less>::fill(const std::vector<T>& sortedValues, size_t& nextValue, const size_t position)
+	{
+		if (position >= data_.size())
+		{
+			return;
+		}
+		fill(sortedValues, nextValue, 2 * position);
+		data_[position] = sortedValues[nextValue++];
+		fill(sortedValues, nextValue, 2 * position + 1);
+	}
+
+	template <typename T, typename Less>
+	size_t EytzingerSnapshot<T, Less>::successor(size_t position) const
+	{
+		const auto size = data_.size() - 1;
+		if (2 * position + 1 <= size)
+		{
+			//Самый левый узел правого поддерева
+			position = 2 * position + 1;
+			while (2 * position <= size)
+			{
+				position = 2 * position;
+			}
+			return position;
+		}
+		return climbToLeftAncestor(position);
+	}
+
+	template <typename T, typename Less>
+	size_t EytzingerSnapshot<T, Less>::climbToLeftAncestor(size_t position)
+	{
+		while ((position & 1) != 0)
+		{
+			position >>= 1;
+		}
+		return position >> 1;
+	}
+
+	template <typename T, typename Less>
+	void EytzingerSnapshot<T, Less>::prefetch(const size_t position) const
+	{
+		//Адрес ограничивается размером массива, чтобы не выходить за его пределы
+		const auto* address = data_.data() + std::min(position << PREFETCH_LEVELS, data_.size() - 1);
+#ifdef _MSC_VER
+		_mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+#else
+		__builtin_prefetch(address);
+#endif
+	}
+}
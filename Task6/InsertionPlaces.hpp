@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
+
+namespace custom_algorithms
+{
+	/**
+	 * \brief Место, куда наивная вставка в двоичное дерево поиска помещает элемент.
+	 */
+	struct InsertionPlace
+	{
+		/**
+		 * \brief Индекс родителя в исходной последовательности. У корня - NO_PARENT.
+		 */
+		uint32_t parent;
+		/**
+		 * \brief True, если элемент - левый потомок родителя, иначе - правый.
+		 */
+		bool isLeft;
+
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+	};
+
+	/**
+	 * \brief Находит для каждого элемента последовательности его родителя в дереве, построенном наивной вставкой элементов по порядку
+	 * \brief (меньший элемент - налево, не меньший - направо), без построения самого дерева.
+	 * \brief Если считать равные элементы упорядоченными по времени вставки, то родитель нового элемента - это тот из его соседей
+	 * \brief по порядку среди уже вставленных (предшественник или преемник), который был вставлен позже.
+	 * \brief Соседей находим, удаляя элементы из двусвязного списка отсортированной последовательности в обратном порядке вставки:
+	 * \brief в момент удаления в списке остаются ровно элементы, вставленные раньше.
+	 * \brief Время работы: O(n log n) при любом порядке элементов, дополнительная память: O(n).
+	 * \tparam T Тип элементов.
+	 * \param values Последовательность вставляемых элементов.
+	 * \param less Функция сравнения элементов. Должна возвращать true, если первый её аргумент меньше второго.
+	 * \return Места вставки элементов в том же порядке, что и values.
+	 */
+	template<typename T>
+	std::vector<InsertionPlace> calculateInsertionPlaces(const std::vector<T>& values, const std::function<bool(const T& lhs, const T& rhs)>& less = std::less<T>())
+	{
+		assert(values.size() < UINT32_MAX);
+		const auto size = static_cast<uint32_t>(values.size());
+		//Устойчивая сортировка упорядочивает равные элементы по времени вставки
+		std::vector<uint32_t> order(size);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&values, &less](const uint32_t lhs, const uint32_t rhs) { return less(values[lhs], values[rhs]); });
+
+		//Двусвязный список по отсортированному порядку. Соседи хранятся как индексы в исходной последовательности.
+		std::vector<uint32_t> previous(size);
+		std::vector<uint32_t> next(size);
+		for (uint32_t position = 0; position < size; ++position)
+		{
+			previous[order[position]] = position == 0 ? InsertionPlace::NO_PARENT : order[position - 1];
+			next[order[position]] = position + 1 == size ? InsertionPlace::NO_PARENT : order[position + 1];
+		}
+		order.clear();
+		order.shrink_to_fit();
+
+		std::vector<InsertionPlace> places(size, { InsertionPlace::NO_PARENT, false });
+		for (auto i = size; i-- > 1;)
+		{
+			const auto predecessor = previous[i];
+			const auto successor = next[i];
+			//NO_PARENT больше любого индекса, поэтому отсутствующий сосед сравнивается отдельно
+			if (successor == InsertionPlace::NO_PARENT || (predecessor != InsertionPlace::NO_PARENT && predecessor > successor))
+			{
+				places[i] = { predecessor, false };
+			}
+			else
+			{
+				places[i] = { successor, true };
+			}
+			if (predecessor != InsertionPlace::NO_PARENT)
+			{
+				next[predecessor] = successor;
+			}
+			if (successor != InsertionPlace::NO_PARENT)
+			{
+				previous[successor] = predecessor;
+			}
+		}
+		return places;
+	}
+}
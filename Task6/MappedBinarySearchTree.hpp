@@ -0,0 +1,337 @@
+﻿#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <cassert>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace custom_containers
+{
+	/**
+	 * \brief Формат файла дерева: заголовок, затем массивы ключей, левых и правых потомков. Каждый массив начинается
+	 * \brief с границы в 8 байт. Узлы пронумерованы в порядке обхода в ширину, корень - узел 0, индекс 0 у потомка означает
+	 * \brief его отсутствие (как в CompactBinarySearchTree). Числа записаны в порядке байт машины, создавшей файл.
+	 */
+	struct TreeFileHeader
+	{
+		uint64_t magic;
+		uint32_t version;
+		uint32_t keySize;
+		uint64_t size;
+		uint64_t reserved;
+
+		static constexpr uint64_t MAGIC = 0x3145455254534242; // "BBSTREE1"
+		static constexpr uint32_t VERSION = 1;
+
+		/**
+		 * \brief Смещение массива ключей от начала файла.
+		 */
+		static constexpr size_t keysOffset() { return alignUp(sizeof(TreeFileHeader)); }
+		/**
+		 * \brief Смещение массива левых потомков от начала файла.
+		 */
+		static constexpr size_t leftOffset(const size_t size, const size_t keySize) { return keysOffset() + alignUp(size * keySize); }
+		/**
+		 * \brief Смещение массива правых потомков от начала файла.
+		 */
+		static constexpr size_t rightOffset(const size_t size, const size_t keySize) { return leftOffset(size, keySize) + alignUp(size * sizeof(uint32_t)); }
+		/**
+		 * \brief Размер файла дерева из size узлов.
+		 */
+		static constexpr size_t fileSize(const size_t size, const size_t keySize) { return rightOffset(size, keySize) + alignUp(size * sizeof(uint32_t)); }
+
+		/**
+		 * \brief Граница, с которой начинается каждый массив. Ключи читаются прямо из отображения, поэтому их выравнивание не может быть больше.
+		 */
+		static constexpr size_t ALIGNMENT = 8;
+
+		static constexpr size_t alignUp(const size_t bytes) { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+	};
+
+	/**
+	 * \brief Запись дерева в файл в формате TreeFileHeader.
+	 * \tparam T Тип ключей. Должен копироваться побайтно, выравнивание - не больше TreeFileHeader::ALIGNMENT.
+	 * \param path Путь к файлу.
+	 * \param keys Ключи узлов.
+	 * \param left Индексы левых потомков.
+	 * \param right Индексы правых потомков.
+	 * \return True, если файл записан, иначе - false.
+	 */
+	template<typename T>
+	bool writeTreeFile(const std::string& path, const std::vector<T>& keys, const std::vector<uint32_t>& left, const std::vector<uint32_t>& right)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Tree keys are stored as raw bytes");
+		static_assert(alignof(T) <= TreeFileHeader::ALIGNMENT, "Tree keys are read in place from arrays aligned to 8 bytes");
+		assert(keys.size() == left.size() && keys.size() == right.size());
+		auto* file = std::fopen(path.c_str(), "wb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+		const auto size = keys.size();
+		const TreeFileHeader header{ TreeFileHeader::MAGIC, TreeFileHeader::VERSION, sizeof(T), size, 0 };
+		const char padding[8] = {};
+		const auto writeArray = [file, &padding](const void* data, const size_t bytes)
+		{
+			const auto paddingBytes = TreeFileHeader::alignUp(bytes) - bytes;
+			return (bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes) && (paddingBytes == 0 || std::fwrite(padding, 1, paddingBytes, file) == paddingBytes);
+		};
+		auto isWritten = writeArray(&header, sizeof(header));
+		isWritten = isWritten && writeArray(keys.data(), size * sizeof(T));
+		isWritten = isWritten && writeArray(left.data(), size * sizeof(uint32_t));
+		isWritten = isWritten && writeArray(right.data(), size * sizeof(uint32_t));
+		return std::fclose(file) == 0 && isWritten;
+	}
+
+	/**
+	 * \brief Дерево поиска, отображённое в память из файла, записанного writeTreeFile. Узлы используются прямо из отображения,
+	 * \brief поэтому открытие не зависит от количества узлов: ни разбора, ни выделения памяти на узел, страницы подгружаются
+	 * \brief системой при первом обращении. Дерево только для чтения. Чтобы продолжить вставку, его копируют в изменяемое
+	 * \brief дерево (CompactBinarySearchTree::materialize, BinarySearchTree::materialize).
+	 * \tparam T Тип ключей. Выравнивание - не больше TreeFileHeader::ALIGNMENT.
+	 */
+	template<typename T>
+	class MappedBinarySearchTree
+	{
+	public:
+		MappedBinarySearchTree() = default;
+		explicit MappedBinarySearchTree(const std::function<bool(const T& lhs, const T& rhs)>& less) : less_(less) {}
+		~MappedBinarySearchTree() { close(); }
+		MappedBinarySearchTree(const MappedBinarySearchTree& other) = delete;
+		MappedBinarySearchTree(MappedBinarySearchTree&& other) noexcept = delete;
+		MappedBinarySearchTree& operator=(const MappedBinarySearchTree& other) = delete;
+		MappedBinarySearchTree& operator=(MappedBinarySearchTree&& other) noexcept = delete;
+
+		/**
+		 * \brief Отображение файла дерева в память. Ранее открытый файл закрывается.
+		 * \param path Путь к файлу.
+		 * \return True, если файл открыт и его формат верен, иначе - false (дерево остаётся пустым).
+		 */
+		bool load(const std::string& path);
+		/**
+		 * \brief Снятие отображения файла.
+		 */
+		void close();
+
+		/**
+		 * \brief Проверяет, содержится ли элемент в дереве. Индекс потомка вне массива или не больший индекса узла
+		 * \brief (повреждённый файл) считается отсутствием потомка, поэтому спуск всегда конечен.
+		 */
+		[[nodiscard]] bool contains(const T& value) const;
+		/**
+		 * \brief Проверка индексов потомков за O(n). Узлы пронумерованы в порядке обхода в ширину, поэтому ненулевые
+		 * \brief индексы потомков, выписанные по порядку узлов (левый, затем правый), образуют последовательность 1, 2, ..., size - 1.
+		 * \return True, если индексы задают дерево, иначе - false.
+		 */
+		[[nodiscard]] bool hasValidChildren() const;
+		/**
+		 * \brief Обход дерева в ширину.
+		 * \tparam Action Тип функции, выполняемой над элементами. Принимает const T&.
+		 */
+		template<typename Action>
+		void bfs(Action&& action) const;
+
+		/**
+		 * \brief Количество элементов в дереве.
+		 */
+		[[nodiscard]] size_t size() const { return size_; }
+		/**
+		 * \brief Массивы узлов в отображении. Действительны до close или уничтожения дерева.
+		 */
+		[[nodiscard]] const T* keys() const { return keys_; }
+		[[nodiscard]] const uint32_t* left() const { return left_; }
+		[[nodiscard]] const uint32_t* right() const { return right_; }
+
+	private:
+		static_assert(std::is_trivially_copyable_v<T>, "Tree keys are stored as raw bytes");
+		static_assert(alignof(T) <= TreeFileHeader::ALIGNMENT, "Tree keys are read in place from arrays aligned to 8 bytes");
+
+		/**
+		 * \brief Проверка заголовка и размера отображённого файла. Индексы потомков при открытии не проверяются: это стоило бы O(n),
+		 * \brief их проверяет hasValidChildren перед копированием в изменяемое дерево.
+		 */
+		[[nodiscard]] bool isValid() const;
+
+		/**
+		 * \brief Индекс, означающий отсутствие потомка.
+		 */
+		static constexpr uint32_t NO_CHILD = 0;
+
+		/**
+		 * \brief Начало и размер отображения.
+		 */
+		const unsigned char* data_{ nullptr };
+		size_t bytes_{ 0 };
+		const T* keys_{ nullptr };
+		const uint32_t* left_{ nullptr };
+		const uint32_t* right_{ nullptr };
+		size_t size_{ 0 };
+		std::function<bool(const T& lhs, const T& rhs)> less_{ std::less<T>() };
+	};
+
+	template <typename T>
+	bool MappedBinarySearchTree<T>::load(const std::string& path)
+	{
+		close();
+#ifdef _WIN32
+		const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(TreeFileHeader)))
+		{
+			//Отображение живёт до UnmapViewOfFile, дескрипторы файла и отображения можно закрыть сразу
+			const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				bytes_ = data_ == nullptr ? 0 : static_cast<size_t>(fileSize.QuadPart);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		const auto file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+		struct stat status {};
+		if (::fstat(file, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(TreeFileHeader))
+		{
+			//Отображение живёт до munmap, дескриптор файла можно закрыть сразу
+			auto* data = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				data_ = static_cast<const unsigned char*>(data);
+				bytes_ = static_cast<size_t>(status.st_size);
+			}
+		}
+		::close(file);
+#endif
+		if (data_ == nullptr)
+		{
+			return false;
+		}
+		if (!isValid())
+		{
+			close();
+			return false;
+		}
+		size_ = static_cast<size_t>(reinterpret_cast<const TreeFileHeader*>(data_)->size);
+		keys_ = reinterpret_cast<const T*>(data_ + TreeFileHeader::keysOffset());
+		left_ = reinterpret_cast<const uint32_t*>(data_ + TreeFileHeader::leftOffset(size_, sizeof(T)));
+		right_ = reinterpret_cast<const uint32_t*>(data_ + TreeFileHeader::rightOffset(size_, sizeof(T)));
+		return true;
+	}
+
+	template <typename T>
+	void MappedBinarySearchTree<T>::close()
+	{
+		if (data_ != nullptr)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(data_);
+#else
+			::munmap(const_cast<unsigned char*>(data_), bytes_);
+#endif
+		}
+		data_ = nullptr;
+		bytes_ = 0;
+		keys_ = nullptr;
+		left_ = nullptr;
+		right_ = nullptr;
+		size_ = 0;
+	}
+
+	template <typename T>
+	bool MappedBinarySearchTree<T>::contains(const T& value) const
+	{
+		if (size_ == 0)
+		{
+			return false;
+		}
+		uint32_t node = 0;
+		while (true)
+		{
+			uint32_t child;
+			if (less_(value, keys_[node]))
+			{
+				child = left_[node];
+			}
+			else if (less_(keys_[node], value))
+			{
+				child = right_[node];
+			}
+			else
+			{
+				return true;
+			}
+			if (child == NO_CHILD || child <= node || child >= size_)
+			{
+				return false;
+			}
+			node = child;
+		}
+	}
+
+	template <typename T>
+	bool MappedBinarySearchTree<T>::hasValidChildren() const
+	{
+		size_t nextChild = 1;
+		for (size_t node = 0; node < size_; ++node)
+		{
+			for (auto child : { left_[node], right_[node] })
+			{
+				if (child == NO_CHILD)
+				{
+					continue;
+				}
+				if (child != nextChild)
+				{
+					return false;
+				}
+				++nextChild;
+			}
+		}
+		return size_ == 0 || nextChild == size_;
+	}
+
+	template <typename T>
+	template <typename Action>
+	void MappedBinarySearchTree<T>::bfs(Action&& action) const
+	{
+		//Узлы в файле уже пронумерованы в порядке обхода в ширину
+		for (size_t node = 0; node < size_; ++node)
+		{
+			action(keys_[node]);
+		}
+	}
+
+	template <typename T>
+	bool MappedBinarySearchTree<T>::isValid() const
+	{
+		const auto* header = reinterpret_cast<const TreeFileHeader*>(data_);
+		if (header->magic != TreeFileHeader::MAGIC || header->version != TreeFileHeader::VERSION || header->keySize != sizeof(T) || header->size >= UINT32_MAX)
+		{
+			return false;
+		}
+		return bytes_ == TreeFileHeader::fileSize(static_cast<size_t>(header->size), sizeof(T));
+	}
+}
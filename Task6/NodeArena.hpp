@@ -0,0 +1,122 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <new>
+#include <cassert>
+
+namespace custom_containers
+{
+	/**
+	 * \brief Пул для объектов одного типа (узлов деревьев и списков).
+	 * \brief Память выделяется блоками, размер блока удваивается от INITIAL_CHUNK_SIZE до MAX_CHUNK_SIZE объектов.
+	 * \brief Внутри блока объекты выделяются сдвигом указателя, освобождённые ячейки попадают в список свободных
+	 * \brief и переиспользуются в первую очередь. Все блоки освобождаются разом в деструкторе.
+	 * \brief Деструкторы живых объектов при этом не вызываются: если они нужны, владелец вызывает destroy сам.
+	 * \tparam T Тип объектов.
+	 */
+	template<typename T>
+	class NodeArena
+	{
+	public:
+		NodeArena() = default;
+		~NodeArena() = default;
+
+		NodeArena(const NodeArena& other) = delete;
+		NodeArena(NodeArena&& other) noexcept = delete;
+		NodeArena& operator=(const NodeArena& other) = delete;
+		NodeArena& operator=(NodeArena&& other) noexcept = delete;
+
+		/**
+		 * \brief Создание объекта в пуле.
+		 * \param args Аргументы конструктора T.
+		 * \return Указатель на созданный объект. Действителен до вызова destroy или уничтожения пула.
+		 */
+		template<typename... Args>
+		T* create(Args&&... args);
+
+		/**
+		 * \brief Уничтожение объекта: вызывается деструктор, ячейка попадает в список свободных.
+		 * \param object Объект, созданный этим пулом.
+		 */
+		void destroy(T* object);
+
+		/**
+		 * \brief Количество живых объектов в пуле.
+		 */
+		[[nodiscard]] size_t size() const { return size_; }
+
+	private:
+		/**
+		 * \brief Ячейка пула: либо место под объект, либо звено списка свободных ячеек.
+		 */
+		union Slot
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		/**
+		 * \brief Выделение ячейки из списка свободных или из текущего блока.
+		 */
+		Slot* allocate();
+
+		/**
+		 * \brief Размер первого блока в объектах.
+		 */
+		static constexpr size_t INITIAL_CHUNK_SIZE = 64;
+		/**
+		 * \brief Максимальный размер блока в объектах.
+		 */
+		static constexpr size_t MAX_CHUNK_SIZE = 1 << 16;
+
+		std::vector<std::unique_ptr<Slot[]>> chunks_;
+		/**
+		 * \brief Размер последнего блока и количество выделенных из него ячеек.
+		 */
+		size_t chunkSize_{ 0 };
+		size_t chunkUsed_{ 0 };
+		Slot* freeList_{ nullptr };
+		size_t size_{ 0 };
+	};
+
+	template <typename T>
+	template <typename... Args>
+	T* NodeArena<T>::create(Args&&... args)
+	{
+		auto* slot = allocate();
+		auto* object = new (slot->storage) T(std::forward<Args>(args)...);
+		size_ += 1;
+		return object;
+	}
+
+	template <typename T>
+	void NodeArena<T>::destroy(T* object)
+	{
+		assert(object != nullptr && size_ > 0);
+		object->~T();
+		auto* slot = reinterpret_cast<Slot*>(object);
+		slot->next = freeList_;
+		freeList_ = slot;
+		size_ -= 1;
+	}
+
+	template <typename T>
+	typename NodeArena<T>::Slot* NodeArena<T>::allocate()
+	{
+		if (freeList_ != nullptr)
+		{
+			auto* slot = freeList_;
+			freeList_ = slot->next;
+			return slot;
+		}
+		if (chunkUsed_ == chunkSize_)
+		{
+			chunkSize_ = chunkSize_ == 0 ? INITIAL_CHUNK_SIZE : std::min(chunkSize_ * 2, MAX_CHUNK_SIZE);
+			chunks_.emplace_back(new Slot[chunkSize_]);
+			chunkUsed_ = 0;
+		}
+		return &chunks_.back()[chunkUsed_++];
+	}
+}
@@ -75,14 +75,30 @@
   */
 
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 #include <functional>
-#include <queue>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <type_traits>
+#include <thread>
+#include <cassert>
+#include "NodeArena.hpp"
+#include "CompactBinarySearchTree.hpp"
+#include "InsertionPlaces.hpp"
+#include "EytzingerSnapshot.hpp"
+#include "BufferedWriter.hpp"
+#include "MappedBinarySearchTree.hpp"
 
 namespace custom_containers
 {
 
 	/**
 	 * \brief Класс, реализующий двоичное дерево поиска в целом и узел дерева в частности.
+	 * \brief Узлы выделяются из пула NodeArena и освобождаются вместе с ним.
 	 * \tparam T Тип элементов, хранящихся в дереве.
 	 */
 	template<typename T>
@@ -99,14 +115,64 @@ namespace custom_containers
 
 		/**
 		 * \brief Обход дерева в ширину.
+		 * \tparam Action Тип функции, выполняемой над элементами. Принимает T&.
 		 * \param action Функция, выполняемая над элементами.
 		 */
-		void bfs(std::function<void(T&)> action);
+		template<typename Action>
+		void bfs(Action&& action);
+		/**
+		 * \brief Параллельный обход дерева в ширину по уровням. Узлы текущего уровня делятся между потоками на непрерывные части,
+		 * \brief каждый поток записывает их ключи на их места в результате и собирает потомков в свой буфер. Буферы
+		 * \brief склеиваются по порядку номеров потоков в следующий уровень, поэтому порядок элементов тот же, что и у bfs.
+		 * \param threadsNumber Количество потоков.
+		 * \return Элементы дерева в порядке обхода в ширину.
+		 */
+		[[nodiscard]] std::vector<T> parallelLevelOrder(size_t threadsNumber = std::thread::hardware_concurrency()) const;
 		/**
 		 * \brief Вставка элемента в дерево.
 		 * \param value Вставляемый элемент.
 		 */
 		void insert(const T& value);
+		/**
+		 * \brief Построение дерева той же формы, что и вставка элементов values по порядку, за O(n log n) при любом их порядке.
+		 * \brief Родитель каждого элемента находится через calculateInsertionPlaces без спуска от корня.
+		 * \param values Вставляемые элементы. Дерево должно быть пустым.
+		 */
+		void build(const std::vector<T>& values);
+		/**
+		 * \brief Вставка последовательности элементов по порядку. Дерево получается таким же, как при вызовах insert.
+		 * \brief Если элемент попадает в интервал ключей, ведущих к последнему вставленному листу, он становится потомком
+		 * \brief этого листа без спуска от корня. Поэтому монотонные участки последовательности вставляются за O(1) на элемент.
+		 * \tparam Range Тип последовательности.
+		 * \param values Вставляемые элементы.
+		 */
+		template<typename Range>
+		void insertBatch(const Range& values);
+		/**
+		 * \brief Проверяет, содержится ли элемент в дереве.
+		 * \param value Искомый элемент.
+		 */
+		[[nodiscard]] bool contains(const T& value) const;
+		/**
+		 * \brief Неизменяемый снимок элементов дерева в раскладке Эйтцингера для быстрого поиска. Дерево при этом не меняется.
+		 * \tparam Less Тип функции сравнения снимка.
+		 * \param less Функция сравнения, упорядочивающая элементы так же, как функция сравнения дерева.
+		 */
+		template<typename Less = std::less<T>>
+		[[nodiscard]] EytzingerSnapshot<T, Less> freeze(const Less& less = Less()) const;
+		/**
+		 * \brief Запись дерева в файл в компактном формате с индексами вместо указателей (TreeFileHeader).
+		 * \brief Файл открывается MappedBinarySearchTree без построения дерева заново.
+		 * \param path Путь к файлу.
+		 * \return True, если файл записан, иначе - false.
+		 */
+		[[nodiscard]] bool save(const std::string& path) const;
+		/**
+		 * \brief Построение дерева той же формы, что и отображённое из файла, для продолжения вставки. Узлы создаются без спуска от корня.
+		 * \param mapped Отображённое дерево. Дерево должно быть пустым.
+		 * \return True, если индексы потомков в файле верны, иначе - false (дерево остаётся пустым).
+		 */
+		[[nodiscard]] bool materialize(const MappedBinarySearchTree<T>& mapped);
 
 	private:
 		/**
@@ -137,10 +203,27 @@ namespace custom_containers
 
 		/**
 		 * \brief Обход дерева в ширину.
+		 * \tparam Action Тип функции, выполняемой над узлами. Принимает Node*.
 		 * \param action Функция, выполняемая над узлами.
 		 */
-		void bfsNodes(std::function<void(Node*)> action);
+		template<typename Action>
+		void bfsNodes(Action&& action);
+
+		/**
+		 * \brief Запускает function(thread) для thread от 0 до threadsNumber - 1 в отдельных потоках и дожидается их завершения.
+		 */
+		template<typename Function>
+		static void runInThreads(size_t threadsNumber, const Function& function);
 
+		/**
+		 * \brief Уровни с меньшим количеством узлов обходятся в одном потоке: запуск потоков дороже их обработки.
+		 */
+		static constexpr size_t PARALLEL_LEVEL_THRESHOLD = 1 << 14;
+
+		/**
+		 * \brief Пул, из которого выделяются узлы дерева.
+		 */
+		NodeArena<Node> nodes_;
 		Node* root_{ nullptr };
 		std::function<bool(const T& lhs, const T& rhs)> less_{ std::less<T>() };
 	};
@@ -148,11 +231,16 @@ namespace custom_containers
 	template <typename T>
 	BinarySearchTree<T>::~BinarySearchTree()
 	{
-		bfsNodes(std::default_delete<Node>());
+		//Память узлов освобождает пул, обходить дерево нужно, только если ключам нужен деструктор
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			bfsNodes([this](Node* node) { nodes_.destroy(node); });
+		}
 	}
 
 	template <typename T>
-	void BinarySearchTree<T>::bfs(std::function<void(T&)> action)
+	template <typename Action>
+	void BinarySearchTree<T>::bfs(Action&& action)
 	{
 		bfsNodes([&action](Node* node)
 		{
@@ -160,12 +248,83 @@ namespace custom_containers
 		});
 	}
 
+	template <typename T>
+	std::vector<T> BinarySearchTree<T>::parallelLevelOrder(size_t threadsNumber) const
+	{
+		threadsNumber = std::max<size_t>(threadsNumber, 1);
+		std::vector<T> result(nodes_.size());
+		std::vector<const Node*> level;
+		std::vector<const Node*> nextLevel;
+		std::vector<std::vector<const Node*>> threadsChildren(threadsNumber);
+		if (root_ != nullptr)
+		{
+			level.push_back(root_);
+		}
+		size_t written = 0;
+		while (!level.empty())
+		{
+			const auto size = level.size();
+			nextLevel.clear();
+			if (size < PARALLEL_LEVEL_THRESHOLD || threadsNumber == 1)
+			{
+				for (size_t i = 0; i < size; ++i)
+				{
+					result[written + i] = level[i]->key_;
+					if (level[i]->left_ != nullptr)
+					{
+						nextLevel.push_back(level[i]->left_);
+					}
+					if (level[i]->right_ != nullptr)
+					{
+						nextLevel.push_back(level[i]->right_);
+					}
+				}
+			}
+			else
+			{
+				runInThreads(threadsNumber, [&](const size_t thread)
+				{
+					const auto begin = size * thread / threadsNumber;
+					const auto end = size * (thread + 1) / threadsNumber;
+					auto& children = threadsChildren[thread];
+					children.clear();
+					for (auto i = begin; i < end; ++i)
+					{
+						result[written + i] = level[i]->key_;
+						if (level[i]->left_ != nullptr)
+						{
+							children.push_back(level[i]->left_);
+						}
+						if (level[i]->right_ != nullptr)
+						{
+							children.push_back(level[i]->right_);
+						}
+					}
+				});
+				std::vector<size_t> offsets(threadsNumber + 1, 0);
+				for (size_t thread = 0; thread < threadsNumber; ++thread)
+				{
+					offsets[thread + 1] = offsets[thread] + threadsChildren[thread].size();
+				}
+				nextLevel.resize(offsets[threadsNumber]);
+				runInThreads(threadsNumber, [&](const size_t thread)
+				{
+					std::copy(threadsChildren[thread].begin(), threadsChildren[thread].end(), nextLevel.begin() + offsets[thread]);
+				});
+			}
+			written += size;
+			std::swap(level, nextLevel);
+		}
+		assert(written == result.size());
+		return result;
+	}
+
 	template <typename T>
 	void BinarySearchTree<T>::insert(const T& value)
 	{
 		if (root_ == nullptr)
 		{
-			root_ = new Node(value);
+			root_ = nodes_.create(value);
 			return;
 		}
 		Node* parent{ nullptr };
@@ -182,7 +341,7 @@ namespace custom_containers
 				insertPlace = insertPlace->right_;
 			}
 		}
-		insertPlace = new Node(value);
+		insertPlace = nodes_.create(value);
 		if (less_(value, parent->key_))
 		{
 			parent->left_ = insertPlace;
@@ -194,21 +353,218 @@ namespace custom_containers
 	}
 
 	template <typename T>
-	void BinarySearchTree<T>::bfsNodes(std::function<void(Node*)> action)
+	void BinarySearchTree<T>::build(const std::vector<T>& values)
+	{
+		assert(root_ == nullptr);
+		const auto places = custom_algorithms::calculateInsertionPlaces(values, less_);
+		std::vector<Node*> nodes(values.size());
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			nodes[i] = nodes_.create(values[i]);
+			if (places[i].parent == custom_algorithms::InsertionPlace::NO_PARENT)
+			{
+				root_ = nodes[i];
+				continue;
+			}
+			auto* parent = nodes[places[i].parent];
+			(places[i].isLeft ? parent->left_ : parent->right_) = nodes[i];
+		}
+	}
+
+	template <typename T>
+	template <typename Range>
+	void BinarySearchTree<T>::insertBatch(const Range& values)
 	{
-		std::queue<Node*> elementsForProcessing;
-		elementsForProcessing.push(root_);
-		while (!elementsForProcessing.empty())
+		//Последний вставленный узел - всегда лист. Спуск от корня приходит в него для ключей из [*lower, *upper),
+		//nullptr означает отсутствие границы. Ключи узлов не перемещаются в памяти, поэтому указатели на них не портятся.
+		Node* previous{ nullptr };
+		const T* lower{ nullptr };
+		const T* upper{ nullptr };
+		for (const auto& value : values)
 		{
-			auto currentElement = elementsForProcessing.front();
-			elementsForProcessing.pop();
+			Node* parent{ nullptr };
+			if (previous != nullptr && (lower == nullptr || !less_(value, *lower)) && (upper == nullptr || less_(value, *upper)))
+			{
+				parent = previous;
+			}
+			else
+			{
+				lower = nullptr;
+				upper = nullptr;
+				for (auto* node = root_; node != nullptr;)
+				{
+					parent = node;
+					if (less_(value, node->key_))
+					{
+						upper = &node->key_;
+						node = node->left_;
+					}
+					else
+					{
+						lower = &node->key_;
+						node = node->right_;
+					}
+				}
+			}
+			previous = nodes_.create(value);
+			if (parent == nullptr)
+			{
+				root_ = previous;
+			}
+			else if (less_(value, parent->key_))
+			{
+				parent->left_ = previous;
+				upper = &parent->key_;
+			}
+			else
+			{
+				parent->right_ = previous;
+				lower = &parent->key_;
+			}
+		}
+	}
+
+	template <typename T>
+	bool BinarySearchTree<T>::contains(const T& value) const
+	{
+		auto* node = root_;
+		while (node != nullptr)
+		{
+			if (less_(value, node->key_))
+			{
+				node = node->left_;
+			}
+			else if (less_(node->key_, value))
+			{
+				node = node->right_;
+			}
+			else
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <typename T>
+	template <typename Less>
+	EytzingerSnapshot<T, Less> BinarySearchTree<T>::freeze(const Less& less) const
+	{
+		//Обход в порядке возрастания на явном стеке: у вырожденного дерева глубина рекурсии была бы равна n
+		std::vector<T> sortedValues;
+		sortedValues.reserve(nodes_.size());
+		std::vector<const Node*> path;
+		const auto* node = root_;
+		while (node != nullptr || !path.empty())
+		{
+			while (node != nullptr)
+			{
+				path.push_back(node);
+				node = node->left_;
+			}
+			node = path.back();
+			path.pop_back();
+			sortedValues.push_back(node->key_);
+			node = node->right_;
+		}
+		return EytzingerSnapshot<T, Less>(sortedValues, less);
+	}
+
+	template <typename T>
+	bool BinarySearchTree<T>::save(const std::string& path) const
+	{
+		//Номер узла - его позиция в очереди обхода в ширину
+		std::vector<const Node*> queue(nodes_.size());
+		std::vector<T> keys(nodes_.size());
+		std::vector<uint32_t> left(nodes_.size(), 0);
+		std::vector<uint32_t> right(nodes_.size(), 0);
+		uint32_t tail = 0;
+		if (root_ != nullptr)
+		{
+			queue[tail++] = root_;
+		}
+		for (uint32_t head = 0; head < tail; ++head)
+		{
+			const auto* node = queue[head];
+			keys[head] = node->key_;
+			if (node->left_ != nullptr)
+			{
+				left[head] = tail;
+				queue[tail++] = node->left_;
+			}
+			if (node->right_ != nullptr)
+			{
+				right[head] = tail;
+				queue[tail++] = node->right_;
+			}
+		}
+		return writeTreeFile(path, keys, left, right);
+	}
+
+	template <typename T>
+	bool BinarySearchTree<T>::materialize(const MappedBinarySearchTree<T>& mapped)
+	{
+		assert(root_ == nullptr);
+		if (!mapped.hasValidChildren())
+		{
+			return false;
+		}
+		std::vector<Node*> nodes(mapped.size());
+		for (size_t i = 0; i < mapped.size(); ++i)
+		{
+			nodes[i] = nodes_.create(mapped.keys()[i]);
+		}
+		//Индекс 0 - корень, у потомка он означает его отсутствие
+		for (size_t i = 0; i < mapped.size(); ++i)
+		{
+			nodes[i]->left_ = mapped.left()[i] == 0 ? nullptr : nodes[mapped.left()[i]];
+			nodes[i]->right_ = mapped.right()[i] == 0 ? nullptr : nodes[mapped.right()[i]];
+		}
+		root_ = nodes.empty() ? nullptr : nodes[0];
+		return true;
+	}
+
+	template <typename T>
+	template <typename Function>
+	void BinarySearchTree<T>::runInThreads(const size_t threadsNumber, const Function& function)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(threadsNumber - 1);
+		for (size_t thread = 1; thread < threadsNumber; ++thread)
+		{
+			threads.emplace_back(function, thread);
+		}
+		function(0);
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	template <typename T>
+	template <typename Action>
+	void BinarySearchTree<T>::bfsNodes(Action&& action)
+	{
+		if (root_ == nullptr)
+		{
+			return;
+		}
+		//Каждый узел попадает в очередь ровно один раз, поэтому очередь - массив на nodes_.size() элементов
+		//с указателями начала и конца, выделяемый один раз
+		std::vector<Node*> elementsForProcessing(nodes_.size());
+		size_t head = 0;
+		size_t tail = 0;
+		elementsForProcessing[tail++] = root_;
+		while (head < tail)
+		{
+			auto currentElement = elementsForProcessing[head++];
 			if (currentElement->left_ != nullptr)
 			{
-				elementsForProcessing.push(currentElement->left_);
+				elementsForProcessing[tail++] = currentElement->left_;
 			}
 			if (currentElement->right_ != nullptr)
 			{
-				elementsForProcessing.push(currentElement->right_);
+				elementsForProcessing[tail++] = currentElement->right_;
 			}
 			action(currentElement);
 		}
@@ -219,16 +575,686 @@ namespace custom_containers
 void processNumbers(const std::vector<int32_t>& numbers)
 {
 	custom_containers::BinarySearchTree<int32_t> tree;
-	for (int number : numbers)
+	tree.build(numbers);
+	custom_algorithms::BufferedWriter output;
+	tree.bfs([&output](const int32_t& number)
+	{
+		output.write(number);
+		output.put(' ');
+	});
+}
+
+
+/**
+ * \brief Построение дерева из последовательности и вывод его обхода в ширину в вектор.
+ * \tparam Tree Тип дерева: BinarySearchTree или CompactBinarySearchTree.
+ */
+template<typename Tree = custom_containers::BinarySearchTree<int32_t>>
+std::vector<int32_t> levelOrder(const std::vector<int32_t>& numbers)
+{
+	Tree tree;
+	for (auto number : numbers)
 	{
 		tree.insert(number);
 	}
-	tree.bfs([](const int32_t& number) {std::cout << number << " "; });
+	std::vector<int32_t> result;
+	tree.bfs([&result](const int32_t& number) { result.push_back(number); });
+	return result;
+}
+
+
+void BinarySearchTreeTest_levelOrder()
+{
+	assert(levelOrder({ 10, 5, 4, 7, 9, 8, 6, 3, 2, 1 }) == std::vector<int32_t>({ 10, 5, 4, 7, 3, 6, 9, 2, 8, 1 }));
+	assert(levelOrder({ 9, 8, 6, 10, 4, 3, 2, 5, 1, 7 }) == std::vector<int32_t>({ 9, 8, 10, 6, 4, 7, 3, 5, 2, 1 }));
+	assert(levelOrder({ 1, 7, 10, 9, 4, 3, 8, 5, 2, 6 }) == std::vector<int32_t>({ 1, 7, 4, 10, 3, 5, 9, 2, 6, 8 }));
+	//Равные ключи уходят в правое поддерево
+	assert(levelOrder({ 5, 5, 3, 5 }) == std::vector<int32_t>({ 5, 3, 5, 5 }));
+	assert(levelOrder({}).empty());
+	//Дерево с ключами, которым нужен деструктор
+	custom_containers::BinarySearchTree<std::string> strings;
+	for (const auto* word : { "level", "order", "binary", "search", "tree" })
+	{
+		strings.insert(word);
+	}
+	std::string joined;
+	strings.bfs([&joined](std::string& word) { joined += word + " "; });
+	assert(joined == "level binary order search tree ");
+}
+
+
+/**
+ * \brief Случайная последовательность ключей для замеров и проверок.
+ * \param n Длина последовательности.
+ * \param modulo Если не 0, то ключи берутся из [0, modulo).
+ */
+std::vector<int32_t> generateNumbers(const size_t n, const uint32_t modulo = 0)
+{
+	std::mt19937 generator(42);
+	std::vector<int32_t> numbers(n);
+	for (auto& number : numbers)
+	{
+		number = static_cast<int32_t>(modulo == 0 ? generator() : generator() % modulo);
+	}
+	return numbers;
+}
+
+
+void CompactBinarySearchTreeTest_matchesPointerTree()
+{
+	using CompactTree = custom_containers::CompactBinarySearchTree<int32_t>;
+	assert(levelOrder<CompactTree>({ 10, 5, 4, 7, 9, 8, 6, 3, 2, 1 }) == std::vector<int32_t>({ 10, 5, 4, 7, 3, 6, 9, 2, 8, 1 }));
+	assert(levelOrder<CompactTree>({}).empty());
+	for (uint32_t modulo : { 0, 10, 1000 })
+	{
+		const auto numbers = generateNumbers(100000, modulo);
+		assert(levelOrder<CompactTree>(numbers) == levelOrder(numbers));
+	}
+}
+
+
+/**
+ * \brief Обход в ширину дерева, построенного методом build.
+ */
+template<typename Tree = custom_containers::BinarySearchTree<int32_t>>
+std::vector<int32_t> levelOrderBuilt(const std::vector<int32_t>& numbers)
+{
+	Tree tree;
+	tree.build(numbers);
+	std::vector<int32_t> result;
+	tree.bfs([&result](const int32_t& number) { result.push_back(number); });
+	return result;
+}
+
+
+void BinarySearchTreeTest_buildMatchesInsert()
+{
+	using CompactTree = custom_containers::CompactBinarySearchTree<int32_t>;
+	assert(levelOrderBuilt({ 10, 5, 4, 7, 9, 8, 6, 3, 2, 1 }) == std::vector<int32_t>({ 10, 5, 4, 7, 3, 6, 9, 2, 8, 1 }));
+	assert(levelOrderBuilt({ 1, 7, 10, 9, 4, 3, 8, 5, 2, 6 }) == std::vector<int32_t>({ 1, 7, 4, 10, 3, 5, 9, 2, 6, 8 }));
+	assert(levelOrderBuilt({}).empty());
+	assert(levelOrderBuilt({ 7 }) == std::vector<int32_t>({ 7 }));
+	for (uint32_t modulo : { 0, 2, 10, 1000 })
+	{
+		auto numbers = generateNumbers(3000, modulo);
+		assert(levelOrderBuilt(numbers) == levelOrder(numbers));
+		assert(levelOrderBuilt<CompactTree>(numbers) == levelOrder(numbers));
+		//Отсортированная, развёрнутая и "зигзагообразная" последовательности дают вырожденные деревья
+		std::sort(numbers.begin(), numbers.end());
+		assert(levelOrderBuilt(numbers) == levelOrder(numbers));
+		std::reverse(numbers.begin(), numbers.end());
+		assert(levelOrderBuilt<CompactTree>(numbers) == levelOrder(numbers));
+		std::vector<int32_t> zigzag;
+		for (size_t i = 0; i < numbers.size() / 2; ++i)
+		{
+			zigzag.push_back(numbers[i]);
+			zigzag.push_back(numbers[numbers.size() - 1 - i]);
+		}
+		assert(levelOrderBuilt(zigzag) == levelOrder(zigzag));
+	}
+}
+
+
+void EytzingerSnapshotTest_matchesSortedArray()
+{
+	custom_containers::BinarySearchTree<int32_t> emptyTree;
+	const auto emptySnapshot = emptyTree.freeze();
+	assert(emptySnapshot.size() == 0 && !emptySnapshot.contains(0) && emptySnapshot.lowerBound(0) == nullptr);
+	for (size_t n : { 1, 2, 7, 8, 3000 })
+	{
+		for (uint32_t modulo : { 0, 10, 1000 })
+		{
+			auto numbers = generateNumbers(n, modulo);
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.build(numbers);
+			const auto snapshot = tree.freeze();
+			assert(snapshot.size() == n);
+			std::sort(numbers.begin(), numbers.end());
+			std::vector<int32_t> queries = { INT32_MIN, INT32_MAX, numbers.front() - 1, numbers.back() + 1 };
+			for (size_t i = 0; i < 200; ++i)
+			{
+				queries.push_back(numbers[i * 7919 % n]);
+				queries.push_back(numbers[i * 104729 % n] + 1);
+			}
+			for (auto query : queries)
+			{
+				const auto expected = std::lower_bound(numbers.begin(), numbers.end(), query);
+				const auto* found = snapshot.lowerBound(query);
+				assert((found == nullptr) == (expected == numbers.end()));
+				assert(found == nullptr || *found == *expected);
+				assert(snapshot.contains(query) == std::binary_search(numbers.begin(), numbers.end(), query));
+				assert(tree.contains(query) == snapshot.contains(query));
+			}
+			for (size_t i = 0; i + 1 < queries.size(); ++i)
+			{
+				const auto low = std::min(queries[i], queries[i + 1]);
+				const auto high = std::max(queries[i], queries[i + 1]);
+				std::vector<int32_t> range;
+				snapshot.forEachInRange(low, high, [&range](const int32_t& number) { range.push_back(number); });
+				assert(range == std::vector<int32_t>(std::lower_bound(numbers.begin(), numbers.end(), low), std::lower_bound(numbers.begin(), numbers.end(), high)));
+			}
+		}
+	}
+	//Дерево и снимок с обратным порядком
+	custom_containers::BinarySearchTree<int32_t> descendingTree{ std::greater<int32_t>() };
+	for (auto number : { 5, 1, 9, 3, 7, 3 })
+	{
+		descendingTree.insert(number);
+	}
+	const auto descendingSnapshot = descendingTree.freeze(std::greater<int32_t>());
+	assert(*descendingSnapshot.lowerBound(6) == 5 && descendingSnapshot.contains(3) && !descendingSnapshot.contains(4));
+	std::vector<int32_t> range;
+	descendingSnapshot.forEachInRange(9, 1, [&range](const int32_t& number) { range.push_back(number); });
+	assert(range == std::vector<int32_t>({ 9, 7, 5, 3, 3 }));
+}
+
+
+void BinarySearchTreeTest_insertBatchMatchesInsert()
+{
+	const auto batchLevelOrder = [](const std::vector<std::vector<int32_t>>& batches)
+	{
+		custom_containers::BinarySearchTree<int32_t> tree;
+		for (const auto& batch : batches)
+		{
+			tree.insertBatch(batch);
+		}
+		std::vector<int32_t> result;
+		tree.bfs([&result](const int32_t& number) { result.push_back(number); });
+		return result;
+	};
+	assert(batchLevelOrder({ { 10, 5, 4, 7, 9, 8, 6, 3, 2, 1 } }) == std::vector<int32_t>({ 10, 5, 4, 7, 3, 6, 9, 2, 8, 1 }));
+	assert(batchLevelOrder({ {}, {} }).empty());
+	assert(batchLevelOrder({ { 5, 5, 3, 5 } }) == std::vector<int32_t>({ 5, 3, 5, 5 }));
+	for (uint32_t modulo : { 0, 2, 10, 1000 })
+	{
+		auto numbers = generateNumbers(3000, modulo);
+		assert(batchLevelOrder({ numbers }) == levelOrder(numbers));
+		//Отсортированные участки вперемешку со случайными
+		auto mixed = numbers;
+		for (size_t begin = 0; begin < mixed.size(); begin += 300)
+		{
+			std::sort(mixed.begin() + begin, mixed.begin() + begin + 100);
+			std::sort(mixed.begin() + begin + 100, mixed.begin() + begin + 200, std::greater<int32_t>());
+		}
+		assert(batchLevelOrder({ mixed }) == levelOrder(mixed));
+		//Несколько вызовов подряд
+		const auto middle = mixed.begin() + mixed.size() / 3;
+		assert(batchLevelOrder({ std::vector<int32_t>(mixed.begin(), middle), std::vector<int32_t>(middle, mixed.end()) }) == levelOrder(mixed));
+		std::sort(numbers.begin(), numbers.end());
+		assert(batchLevelOrder({ numbers }) == levelOrder(numbers));
+		std::reverse(numbers.begin(), numbers.end());
+		assert(batchLevelOrder({ numbers }) == levelOrder(numbers));
+	}
+}
+
+
+void BufferedWriterTest_matchesStream()
+{
+	const std::vector<int64_t> numbers = { 0, -1, 7, INT64_MIN, INT64_MAX, INT32_MIN, 1234567890 };
+	for (size_t capacity : { 20, 32, 1 << 16 })
+	{
+		auto* file = std::tmpfile();
+		assert(file != nullptr);
+		std::string expected;
+		{
+			custom_algorithms::BufferedWriter output(file, capacity);
+			for (size_t repeat = 0; repeat < 100; ++repeat)
+			{
+				for (auto number : numbers)
+				{
+					output.write(number);
+					output.put(' ');
+					expected += std::to_string(number) + " ";
+				}
+			}
+			output.write(uint8_t{ 255 });
+			expected += "255";
+		}
+		std::rewind(file);
+		std::string written(expected.size() + 1, '\0');
+		written.resize(std::fread(&written[0], 1, written.size(), file));
+		std::fclose(file);
+		assert(written == expected);
+	}
+}
+
+
+void BinarySearchTreeTest_parallelLevelOrderMatchesBfs()
+{
+	custom_containers::BinarySearchTree<int32_t> emptyTree;
+	assert(emptyTree.parallelLevelOrder(4).empty());
+	for (uint32_t modulo : { 0, 10 })
+	{
+		//На 200000 случайных ключах самые широкие уровни больше порога параллельной обработки
+		auto numbers = generateNumbers(200000, modulo);
+		for (auto isSorted : { false, true })
+		{
+			if (isSorted)
+			{
+				std::sort(numbers.begin(), numbers.begin() + 3000);
+				numbers.resize(3000);
+			}
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.build(numbers);
+			std::vector<int32_t> expected;
+			tree.bfs([&expected](const int32_t& number) { expected.push_back(number); });
+			for (size_t threadsNumber : { 0, 1, 2, 3, 8 })
+			{
+				assert(tree.parallelLevelOrder(threadsNumber) == expected);
+			}
+		}
+	}
+}
+
+
+void MappedBinarySearchTreeTest_saveAndLoad()
+{
+	const std::string path = "mapped_tree_test.bin";
+	custom_containers::MappedBinarySearchTree<int32_t> mapped;
+	assert(!mapped.load("missing_tree_file.bin") && mapped.size() == 0);
+	for (uint32_t modulo : { 0, 10 })
+	{
+		for (size_t n : { 0, 1, 3000 })
+		{
+			auto numbers = generateNumbers(n, modulo);
+			if (modulo == 10)
+			{
+				std::sort(numbers.begin(), numbers.end());
+			}
+			const auto extra = generateNumbers(500, modulo == 0 ? 0 : 20);
+			auto allNumbers = numbers;
+			allNumbers.insert(allNumbers.end(), extra.begin(), extra.end());
+			const auto expected = levelOrder(numbers);
+
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.build(numbers);
+			assert(tree.save(path));
+			assert(mapped.load(path) && mapped.size() == n);
+			std::vector<int32_t> mappedOrder;
+			mapped.bfs([&mappedOrder](const int32_t& number) { mappedOrder.push_back(number); });
+			assert(mappedOrder == expected);
+			for (auto query : extra)
+			{
+				assert(mapped.contains(query) == tree.contains(query));
+			}
+
+			//Вставка продолжается после копирования в изменяемые деревья
+			custom_containers::BinarySearchTree<int32_t> restored;
+			assert(restored.materialize(mapped));
+			custom_containers::CompactBinarySearchTree<int32_t> compact;
+			assert(compact.materialize(mapped));
+			for (auto number : extra)
+			{
+				restored.insert(number);
+				compact.insert(number);
+			}
+			std::vector<int32_t> restoredOrder;
+			restored.bfs([&restoredOrder](const int32_t& number) { restoredOrder.push_back(number); });
+			assert(restoredOrder == levelOrder(allNumbers));
+			std::vector<int32_t> compactOrder;
+			compact.bfs([&compactOrder](const int32_t& number) { compactOrder.push_back(number); });
+			assert(compactOrder == restoredOrder);
+
+			//Компактное дерево пишет тот же формат, что и дерево из указателей
+			assert(compact.save(path) && mapped.load(path));
+			mappedOrder.clear();
+			mapped.bfs([&mappedOrder](const int32_t& number) { mappedOrder.push_back(number); });
+			assert(mappedOrder == restoredOrder);
+		}
+	}
+	//Повреждённые индексы потомков: выход за массив, цикл, общий потомок. Поиск завершается, копирование отказывается
+	const std::vector<int32_t> keys{ 5, 3, 8 };
+	assert(custom_containers::writeTreeFile(path, keys, { 1, 0, 0 }, { 2, 0, 0 }));
+	assert(mapped.load(path) && mapped.hasValidChildren() && mapped.contains(3) && !mapped.contains(2));
+	for (const auto& [left, right] : std::vector<std::pair<std::vector<uint32_t>, std::vector<uint32_t>>>{
+		{ { 7, 0, 0 }, { 2, 0, 0 } }, { { 1, 1, 0 }, { 2, 0, 0 } }, { { 1, 0, 0 }, { 1, 0, 0 } }, { { 2, 0, 0 }, { 1, 0, 0 } } })
+	{
+		assert(custom_containers::writeTreeFile(path, keys, left, right));
+		assert(mapped.load(path) && !mapped.hasValidChildren());
+		assert(!mapped.contains(2) && !mapped.contains(9) && mapped.contains(5));
+		custom_containers::BinarySearchTree<int32_t> restored;
+		assert(!restored.materialize(mapped) && !restored.contains(5));
+		custom_containers::CompactBinarySearchTree<int32_t> compact;
+		assert(!compact.materialize(mapped) && compact.size() == 0);
+	}
+	//Файл с ключами другого размера и обрезанный файл не открываются
+	custom_containers::MappedBinarySearchTree<int64_t> wrongKeys;
+	assert(!wrongKeys.load(path) && wrongKeys.size() == 0);
+	mapped.close();
+	auto* file = std::fopen(path.c_str(), "rb");
+	assert(file != nullptr);
+	std::vector<char> bytes(1 << 16);
+	bytes.resize(std::fread(bytes.data(), 1, bytes.size(), file));
+	std::fclose(file);
+	file = std::fopen(path.c_str(), "wb");
+	std::fwrite(bytes.data(), 1, bytes.size() - 8, file);
+	std::fclose(file);
+	assert(!mapped.load(path));
+	std::remove(path.c_str());
+}
+
+
+/**
+ * \brief Замер построения, обхода и уничтожения дерева.
+ * \tparam Tree Тип дерева: BinarySearchTree или CompactBinarySearchTree.
+ */
+template<typename Tree>
+void benchmarkTree(const std::string& treeName, const std::vector<int32_t>& numbers)
+{
+	int64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	{
+		Tree tree;
+		for (auto number : numbers)
+		{
+			tree.insert(number);
+		}
+		const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		tree.bfs([&checksum](const int32_t& number) { checksum += number; });
+		const std::chrono::duration<double, std::milli> traverseTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		std::cout << treeName << ", n = " << numbers.size() << ": build " << buildTime.count() << " ms, bfs " << traverseTime.count() << " ms";
+	}
+	const std::chrono::duration<double, std::milli> destroyTime = std::chrono::steady_clock::now() - start;
+	std::cout << ", destroy " << destroyTime.count() << " ms (checksum " << checksum << ")" << std::endl;
+}
+
+
+void BinarySearchTreeBenchmark_buildAndTraverse()
+{
+	const auto numbers = generateNumbers(1000000);
+	benchmarkTree<custom_containers::BinarySearchTree<int32_t>>("BinarySearchTree", numbers);
+	benchmarkTree<custom_containers::CompactBinarySearchTree<int32_t>>("CompactBinarySearchTree", numbers);
+}
+
+
+void BinarySearchTreeBenchmark_buildSorted()
+{
+	for (size_t n : { 10000, 30000, 1000000 })
+	{
+		auto numbers = generateNumbers(n);
+		std::sort(numbers.begin(), numbers.end());
+		//Вставка по одному элементу на отсортированной последовательности работает за O(n^2), поэтому замеряется только на малых n
+		if (n <= 30000)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			custom_containers::BinarySearchTree<int32_t> tree;
+			for (auto number : numbers)
+			{
+				tree.insert(number);
+			}
+			const std::chrono::duration<double, std::milli> insertTime = std::chrono::steady_clock::now() - start;
+			std::cout << "sorted, n = " << n << ": insert " << insertTime.count() << " ms, ";
+		}
+		else
+		{
+			std::cout << "sorted, n = " << n << ": ";
+		}
+		const auto start = std::chrono::steady_clock::now();
+		custom_containers::BinarySearchTree<int32_t> tree;
+		tree.build(numbers);
+		const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+		std::cout << "build " << buildTime.count() << " ms" << std::endl;
+	}
+	const auto numbers = generateNumbers(1000000);
+	auto start = std::chrono::steady_clock::now();
+	{
+		custom_containers::BinarySearchTree<int32_t> tree;
+		for (auto number : numbers)
+		{
+			tree.insert(number);
+		}
+	}
+	const std::chrono::duration<double, std::milli> insertTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	{
+		custom_containers::BinarySearchTree<int32_t> tree;
+		tree.build(numbers);
+	}
+	const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+	std::cout << "random, n = " << numbers.size() << ": insert " << insertTime.count() << " ms, build " << buildTime.count() << " ms" << std::endl;
+}
+
+
+void BinarySearchTreeBenchmark_printLevelOrder()
+{
+	const auto numbers = generateNumbers(1000000);
+	custom_containers::BinarySearchTree<int32_t> tree;
+	tree.build(numbers);
+	int64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	tree.bfs([&checksum](const int32_t& number) { checksum += number; });
+	const std::chrono::duration<double, std::milli> traverseTime = std::chrono::steady_clock::now() - start;
+	const auto* path = "level_order_benchmark.txt";
+	//Прежний способ: обход через std::function и вывод потоком по одному числу
+	start = std::chrono::steady_clock::now();
+	{
+		std::ofstream output(path);
+		const std::function<void(int32_t&)> print = [&output](const int32_t& number) { output << number << " "; };
+		tree.bfs(print);
+	}
+	const std::chrono::duration<double, std::milli> streamTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	{
+		auto* file = std::fopen(path, "wb");
+		{
+			custom_algorithms::BufferedWriter output(file);
+			tree.bfs([&output](const int32_t& number)
+			{
+				output.write(number);
+				output.put(' ');
+			});
+		}
+		std::fclose(file);
+	}
+	const std::chrono::duration<double, std::milli> bufferedTime = std::chrono::steady_clock::now() - start;
+	std::remove(path);
+	std::cout << "print level order, n = " << numbers.size() << ": std::function + stream " << streamTime.count()
+		<< " ms, template visitor + BufferedWriter " << bufferedTime.count() << " ms (traversal alone " << traverseTime.count() << " ms, checksum " << checksum << ")" << std::endl;
+}
+
+
+void BinarySearchTreeBenchmark_insertBatch()
+{
+	const auto measure = [](const std::string& name, const std::vector<int32_t>& numbers, bool withInsert)
+	{
+		std::cout << name << ", n = " << numbers.size() << ": ";
+		if (withInsert)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			custom_containers::BinarySearchTree<int32_t> tree;
+			for (auto number : numbers)
+			{
+				tree.insert(number);
+			}
+			const std::chrono::duration<double, std::milli> insertTime = std::chrono::steady_clock::now() - start;
+			std::cout << "insert " << insertTime.count() << " ms, ";
+		}
+		auto start = std::chrono::steady_clock::now();
+		{
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.insertBatch(numbers);
+		}
+		const std::chrono::duration<double, std::milli> batchTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		{
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.build(numbers);
+		}
+		const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+		std::cout << "insertBatch " << batchTime.count() << " ms, build " << buildTime.count() << " ms" << std::endl;
+	};
+	const auto numbers = generateNumbers(1000000);
+	measure("random", numbers, true);
+	//Отсортированные участки по 1000 элементов, начинающиеся со случайных ключей
+	auto mixed = numbers;
+	for (size_t begin = 0; begin < mixed.size(); begin += 1000)
+	{
+		std::sort(mixed.begin() + begin, mixed.begin() + begin + 1000);
+	}
+	measure("sorted runs of 1000", mixed, true);
+	auto sorted = numbers;
+	std::sort(sorted.begin(), sorted.end());
+	//Вставка по одному элементу на отсортированной последовательности работает за O(n^2)
+	measure("sorted", sorted, false);
+}
+
+
+void BinarySearchTreeBenchmark_parallelLevelOrder()
+{
+	for (size_t n : { 1000000, 10000000 })
+	{
+		const auto numbers = generateNumbers(n);
+		custom_containers::BinarySearchTree<int32_t> tree;
+		tree.build(numbers);
+		auto start = std::chrono::steady_clock::now();
+		std::vector<int32_t> expected;
+		expected.reserve(n);
+		tree.bfs([&expected](const int32_t& number) { expected.push_back(number); });
+		const std::chrono::duration<double, std::milli> sequentialTime = std::chrono::steady_clock::now() - start;
+		std::cout << "level order, n = " << n << ": bfs " << sequentialTime.count() << " ms";
+		for (size_t threadsNumber : { 1, 2, 4, 8 })
+		{
+			start = std::chrono::steady_clock::now();
+			const auto result = tree.parallelLevelOrder(threadsNumber);
+			const std::chrono::duration<double, std::milli> parallelTime = std::chrono::steady_clock::now() - start;
+			assert(result == expected);
+			std::cout << ", " << threadsNumber << " threads " << parallelTime.count() << " ms";
+		}
+		std::cout << " (hardware threads: " << std::thread::hardware_concurrency() << ")" << std::endl;
+	}
+}
+
+
+void MappedBinarySearchTreeBenchmark_startup()
+{
+	const std::string path = "mapped_tree_benchmark.bin";
+	for (size_t n : { 1000000, 10000000 })
+	{
+		const auto numbers = generateNumbers(n);
+		auto start = std::chrono::steady_clock::now();
+		{
+			custom_containers::BinarySearchTree<int32_t> tree;
+			tree.build(numbers);
+			const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+			start = std::chrono::steady_clock::now();
+			const auto isSaved = tree.save(path);
+			assert(isSaved);
+			const std::chrono::duration<double, std::milli> saveTime = std::chrono::steady_clock::now() - start;
+			std::cout << "n = " << n << ": build " << buildTime.count() << " ms, save " << saveTime.count() << " ms";
+		}
+		//Файл только что записан и лежит в кеше страниц, поэтому замеряется "тёплый" запуск
+		start = std::chrono::steady_clock::now();
+		custom_containers::MappedBinarySearchTree<int32_t> mapped;
+		const auto isLoaded = mapped.load(path);
+		assert(isLoaded);
+		const auto isFound = mapped.contains(numbers[n / 2]);
+		assert(isFound);
+		const std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		int64_t checksum = 0;
+		mapped.bfs([&checksum](const int32_t& number) { checksum += number; });
+		const std::chrono::duration<double, std::milli> traverseTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		{
+			custom_containers::CompactBinarySearchTree<int32_t> compact;
+			const auto isMaterialized = compact.materialize(mapped);
+			assert(isMaterialized);
+		}
+		const std::chrono::duration<double, std::milli> compactTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		{
+			custom_containers::BinarySearchTree<int32_t> tree;
+			const auto isMaterialized = tree.materialize(mapped);
+			assert(isMaterialized);
+		}
+		const std::chrono::duration<double, std::milli> pointerTime = std::chrono::steady_clock::now() - start;
+		std::cout << "; load + first lookup " << loadTime.count() << " ms, mapped bfs " << traverseTime.count()
+			<< " ms, materialize compact " << compactTime.count() << " ms, materialize pointer tree " << pointerTime.count()
+			<< " ms (checksum " << checksum << ")" << std::endl;
+	}
+	std::remove(path.c_str());
+}
+
+
+void EytzingerSnapshotBenchmark_lookups()
+{
+	//При n = 10^8 дерево из указателей занимает больше 2 Гб, поэтому этот размер нужно включать вручную на машине с запасом памяти
+	for (size_t n : { 1000000, 10000000 })
+	{
+		const auto numbers = generateNumbers(n);
+		custom_containers::BinarySearchTree<int32_t> tree;
+		tree.build(numbers);
+		auto start = std::chrono::steady_clock::now();
+		const auto snapshot = tree.freeze();
+		const std::chrono::duration<double, std::milli> freezeTime = std::chrono::steady_clock::now() - start;
+		//Половина запросов - ключи из дерева, половина - случайные числа (почти всегда отсутствующие)
+		std::mt19937 generator(7);
+		std::vector<int32_t> queries(1000000);
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			queries[i] = i % 2 == 0 ? numbers[generator() % n] : static_cast<int32_t>(generator());
+		}
+		auto sorted = numbers;
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t treeFound = 0;
+		start = std::chrono::steady_clock::now();
+		for (auto query : queries)
+		{
+			treeFound += static_cast<size_t>(tree.contains(query));
+		}
+		const std::chrono::duration<double, std::milli> treeTime = std::chrono::steady_clock::now() - start;
+		size_t snapshotFound = 0;
+		start = std::chrono::steady_clock::now();
+		for (auto query : queries)
+		{
+			snapshotFound += static_cast<size_t>(snapshot.contains(query));
+		}
+		const std::chrono::duration<double, std::milli> snapshotTime = std::chrono::steady_clock::now() - start;
+		size_t sortedFound = 0;
+		start = std::chrono::steady_clock::now();
+		for (auto query : queries)
+		{
+			sortedFound += static_cast<size_t>(std::binary_search(sorted.begin(), sorted.end(), query));
+		}
+		const std::chrono::duration<double, std::milli> sortedTime = std::chrono::steady_clock::now() - start;
+		assert(treeFound == snapshotFound && snapshotFound == sortedFound);
+		std::cout << "n = " << n << ", " << queries.size() << " lookups: tree " << treeTime.count() << " ms, snapshot " << snapshotTime.count()
+			<< " ms, sorted array " << sortedTime.count() << " ms (freeze " << freezeTime.count() << " ms, found " << snapshotFound << ")" << std::endl;
+	}
 }
 
 
 int main()
 {
+	const auto is_test = false;
+	if (is_test)
+	{
+		BinarySearchTreeTest_levelOrder();
+		CompactBinarySearchTreeTest_matchesPointerTree();
+		BinarySearchTreeTest_buildMatchesInsert();
+		EytzingerSnapshotTest_matchesSortedArray();
+		BinarySearchTreeTest_insertBatchMatchesInsert();
+		BufferedWriterTest_matchesStream();
+		BinarySearchTreeTest_parallelLevelOrderMatchesBfs();
+		MappedBinarySearchTreeTest_saveAndLoad();
+		return 0;
+	}
+	const auto is_benchmark = false;
+	if (is_benchmark)
+	{
+		BinarySearchTreeBenchmark_buildAndTraverse();
+		BinarySearchTreeBenchmark_buildSorted();
+		BinarySearchTreeBenchmark_insertBatch();
+		BinarySearchTreeBenchmark_printLevelOrder();
+		BinarySearchTreeBenchmark_parallelLevelOrder();
+		MappedBinarySearchTreeBenchmark_startup();
+		EytzingerSnapshotBenchmark_lookups();
+		return 0;
+	}
+
 	size_t n{ 0 };
 	std::cin >> n;
 	std::vector<int32_t> numbers;